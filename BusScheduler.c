@@ -0,0 +1,196 @@
+/**
+ * @file BusScheduler.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the multi-sensor I2C bus scheduler, and related variables, methods
+ *
+ * The BusScheduler object owns a table of VCNLXXXX sensors, each reached by I2C address and optionally a
+ * TCA9548 style mux channel. Every sensor runs its own PS trigger/read pipeline, and BusScheduler_Poll()
+ * services whichever sensors have a completed conversion that is due, so conversions on different sensors
+ * overlap and the bus is only held for the transactions themselves. Bus busy time is accumulated to report
+ * utilization.
+ *
+ * The sketch drives its single VCNL from the sensor task with RegCache and PsPipeline directly, as its
+ * Scheduler and RateControl own the sampling period; the bus scheduler is for boards with several sensors
+ * behind a mux, and host/bus_sim runs it against simulated devices.
+ */
+
+
+#include "BusScheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Init_BusScheduler(BusScheduler* bus, uint8_t muxAddress, BusRead read, RegWrite write, BusSelect select, SchedClock clock)
+{
+	bus->sensorCount = 0;
+	bus->muxAddress = muxAddress;
+	bus->muxChannel = BUS_NO_MUX;
+	bus->read = read;
+	bus->write = write;
+	bus->select = select;
+	bus->clock = clock;
+	bus->nextIndex = 0;
+
+	BusScheduler_Reset_Stats(bus);
+}
+
+int8_t BusScheduler_Add(BusScheduler* bus, uint8_t address, uint8_t muxChannel, Sensor* sensor, uint32_t period, uint32_t conversionTime)
+{
+	BusSensor* entry;
+
+	if (bus->sensorCount >= BUS_MAX_SENSORS) return -1;
+
+	entry = &bus->sensors[bus->sensorCount];
+	entry->muxChannel = muxChannel;
+	entry->sensor = sensor;
+	entry->period = period;
+	entry->nextSample = bus->clock();
+	entry->errorCount = 0;
+	Init_RegCache(&entry->regs, address, bus->write);
+	Init_PsPipeline(&entry->pipeline, conversionTime);
+
+	return bus->sensorCount++;
+}
+
+/**
+ * @brief Route bus to sensor's mux channel if not already selected
+ *
+ * @param [out] bus
+ * @param [in] entry
+ * @return 0 on success, otherwise bus error
+ */
+static uint8_t BusScheduler_Select(BusScheduler* bus, BusSensor* entry)
+{
+	uint8_t status;
+
+	if ((entry->muxChannel == BUS_NO_MUX) || (entry->muxChannel == bus->muxChannel)) return 0;
+
+	status = bus->select(bus->muxAddress, (uint8_t) (1 << entry->muxChannel));
+	bus->selectCount++;
+	bus->muxChannel = (status == 0) ? entry->muxChannel : BUS_NO_MUX;
+
+	return status;
+}
+
+uint8_t BusScheduler_Write(BusScheduler* bus, uint8_t index, uint8_t cmd, uint8_t lsb, uint8_t msb)
+{
+	BusSensor* entry = &bus->sensors[index];
+	uint8_t status;
+	uint32_t start = bus->clock();
+
+	status = BusScheduler_Select(bus, entry);
+	if (status == 0) status = RegCache_Write(&entry->regs, cmd, lsb, msb);
+	if (status != 0) entry->errorCount++;
+
+	bus->busyTime += bus->clock() - start;
+	return status;
+}
+
+/**
+ * @brief Read finished conversion of a sensor if any, trigger its next one, update sensor state
+ *
+ * @param [out] bus
+ * @param [in] entry
+ * @return 1 if a PS result was read, otherwise 0
+ */
+static uint8_t BusScheduler_Service(BusScheduler* bus, BusSensor* entry)
+{
+	uint8_t isValid = 0;
+	uint16_t psVal = 0;
+	uint32_t start = bus->clock();
+
+	if (BusScheduler_Select(bus, entry) != 0)
+	{
+		entry->errorCount++;
+		bus->busyTime += bus->clock() - start;
+		return 0;
+	}
+
+	//	Read previous conversion, then start the next one before processing
+	if (entry->pipeline.pending)
+	{
+		if (bus->read(entry->regs.address, BUS_CMD_PS1_DATA, &psVal) == 0)
+			isValid = PsPipeline_Read(&entry->pipeline, bus->clock());
+		else
+		{
+			entry->pipeline.pending = 0;
+			entry->errorCount++;
+		}
+	}
+
+	if (RegCache_Trigger(&entry->regs, BUS_CMD_PS_CONF3_MS) == 0)
+		PsPipeline_Trigger(&entry->pipeline, bus->clock());
+	else
+		entry->errorCount++;
+
+	//	Advance from the previous due time so servicing late does not drift the rate, skipping any periods
+	//	already passed so a late sensor does not burst
+	entry->nextSample += entry->period;
+	while (SCHED_TIME_REACHED(bus->clock(), entry->nextSample))
+		entry->nextSample += entry->period;
+	bus->busyTime += bus->clock() - start;
+
+	if (!isValid) return 0;
+
+	Update_Sensor_PS(entry->sensor, psVal);
+	bus->sampleCount++;
+	return 1;
+}
+
+uint8_t BusScheduler_Poll(BusScheduler* bus)
+{
+	uint8_t k, pass, index, sampled = 0;
+	uint8_t visited = 0;	// Bit mask of sensors already considered this poll
+	uint32_t now;
+	BusSensor* entry;
+
+	//	First pass services sensors reachable without a mux switch, second pass the rest
+	for (pass = 0; pass < 2; pass++)
+	{
+		for (k = 0; k < bus->sensorCount; k++)
+		{
+			index = (bus->nextIndex + k) % bus->sensorCount;
+			entry = &bus->sensors[index];
+			if (visited & (1 << index)) continue;
+			if ((pass == 0) && (entry->muxChannel != BUS_NO_MUX) && (entry->muxChannel != bus->muxChannel))
+				continue;
+			visited |= (1 << index);
+
+			//	Not before the due time even without a conversion in flight, so a failed trigger backs off
+			now = bus->clock();
+			if (!SCHED_TIME_REACHED(now, entry->nextSample) ||
+				(entry->pipeline.pending && !PsPipeline_Ready(&entry->pipeline, now)))
+				continue;
+
+			sampled += BusScheduler_Service(bus, entry);
+		}
+	}
+
+	if (bus->sensorCount > 0)
+		bus->nextIndex = (bus->nextIndex + 1) % bus->sensorCount;
+
+	return sampled;
+}
+
+uint16_t BusScheduler_Utilization(const BusScheduler* bus)
+{
+	uint32_t elapsed = bus->clock() - bus->statStart;
+
+	if (elapsed == 0) return 0;
+
+	return (uint16_t) (((uint64_t) bus->busyTime * 1000) / elapsed);
+}
+
+void BusScheduler_Reset_Stats(BusScheduler* bus)
+{
+	bus->statStart = bus->clock ? bus->clock() : 0;
+	bus->busyTime = 0;
+	bus->sampleCount = 0;
+	bus->selectCount = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file BusScheduler.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the multi-sensor I2C bus scheduler, and related variables, methods
+ *
+ * The BusScheduler object owns a table of VCNLXXXX sensors, each reached by I2C address and optionally a
+ * TCA9548 style mux channel. Every sensor runs its own PS trigger/read pipeline, and BusScheduler_Poll()
+ * services whichever sensors have a completed conversion that is due, so conversions on different sensors
+ * overlap and the bus is only held for the transactions themselves. Bus busy time is accumulated to report
+ * utilization.
+ *
+ * The sketch drives its single VCNL from the sensor task with RegCache and PsPipeline directly, as its
+ * Scheduler and RateControl own the sampling period; the bus scheduler is for boards with several sensors
+ * behind a mux, and host/bus_sim runs it against simulated devices.
+ */
+
+#ifndef BUSSCHEDULER_H_
+#define BUSSCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Sensor.h"
+#include "RegCache.h"
+#include "PsPipeline.h"
+#include "Scheduler.h"
+
+/** @brief Maximum number of sensors on a bus, at most 8 */
+#ifndef BUS_MAX_SENSORS
+#define BUS_MAX_SENSORS 4
+#endif
+
+/** @brief Mux channel of a sensor attached directly to the bus */
+#define BUS_NO_MUX 0xFF
+
+/** @brief PS result command code */
+#define BUS_CMD_PS1_DATA 0x08
+
+/** @brief PS_CONF3/PS_MS command code */
+#define BUS_CMD_PS_CONF3_MS 0x04
+
+/**
+ * @brief Bus read of one command register, returns 0 on success
+ */
+typedef uint8_t (*BusRead)(uint8_t address, uint8_t cmd, uint16_t* value);
+
+/**
+ * @brief Bus write of the mux channel mask, returns 0 on success
+ */
+typedef uint8_t (*BusSelect)(uint8_t muxAddress, uint8_t mask);
+
+/**
+ * @struct BusSensor_t
+ * @brief Sensor table entry
+ */
+typedef struct BusSensor_t
+{
+	/** @brief Mux channel, #BUS_NO_MUX if attached directly */
+	uint8_t muxChannel;
+
+	/** @brief Sensor state updated with every PS result */
+	Sensor* sensor;
+
+	/** @brief Register shadow, also holding the device address */
+	RegCache regs;
+
+	/** @brief Conversion in flight */
+	PsPipeline pipeline;
+
+	/** @brief PS sampling period (in us) */
+	uint32_t period;
+
+	/** @brief Time the next conversion is due to be read (in us) */
+	uint32_t nextSample;
+
+	/** @brief Number of bus errors */
+	uint32_t errorCount;
+} BusSensor;
+
+/**
+ * @struct BusScheduler_t
+ * @brief Bus scheduler struct holding the sensor table, bus backend and utilization counters
+ */
+typedef struct BusScheduler_t
+{
+	/** @brief Sensor table */
+	BusSensor sensors[BUS_MAX_SENSORS];
+
+	/** @brief Number of sensors in table */
+	uint8_t sensorCount;
+
+	/** @brief Mux I2C address */
+	uint8_t muxAddress;
+
+	/** @brief Currently selected mux channel, #BUS_NO_MUX if unknown */
+	uint8_t muxChannel;
+
+	/** @brief Bus register read */
+	BusRead read;
+
+	/** @brief Bus register write */
+	RegWrite write;
+
+	/** @brief Bus mux select */
+	BusSelect select;
+
+	/** @brief Time source (in us) */
+	SchedClock clock;
+
+	/** @brief Sensor serviced first on the next poll, for round robin fairness */
+	uint8_t nextIndex;
+
+	/** @brief Start of the utilization measurement (in us) */
+	uint32_t statStart;
+
+	/** @brief Bus busy time since \ref BusScheduler.statStart (in us) */
+	uint32_t busyTime;
+
+	/** @brief Number of PS samples since \ref BusScheduler.statStart */
+	uint32_t sampleCount;
+
+	/** @brief Number of mux selects since \ref BusScheduler.statStart */
+	uint32_t selectCount;
+} BusScheduler;
+
+/**
+ * @brief Initialize bus scheduler with an empty sensor table
+ *
+ * @param [out] bus
+ * @param [in] muxAddress
+ * @param [in] read
+ * @param [in] write
+ * @param [in] select
+ * @param [in] clock
+ */
+void Init_BusScheduler(BusScheduler* bus, uint8_t muxAddress, BusRead read, RegWrite write, BusSelect select, SchedClock clock);
+
+/**
+ * @brief Add sensor to table
+ *
+ * @param [out] bus
+ * @param [in] address
+ * @param [in] muxChannel #BUS_NO_MUX if attached directly
+ * @param [in] sensor
+ * @param [in] period (in us)
+ * @param [in] conversionTime (in us)
+ * @return sensor table index, or -1 if the table is full
+ */
+int8_t BusScheduler_Add(BusScheduler* bus, uint8_t address, uint8_t muxChannel, Sensor* sensor, uint32_t period, uint32_t conversionTime);
+
+/**
+ * @brief Write command register of a sensor through its register shadow
+ *
+ * @param [out] bus
+ * @param [in] index
+ * @param [in] cmd
+ * @param [in] lsb
+ * @param [in] msb
+ * @return 0 on success, otherwise bus error
+ */
+uint8_t BusScheduler_Write(BusScheduler* bus, uint8_t index, uint8_t cmd, uint8_t lsb, uint8_t msb);
+
+/**
+ * @brief Service every sensor with a completed, due conversion: read result, trigger next, update sensor
+ *
+ * @param [out] bus
+ * @return number of sensors sampled
+ */
+uint8_t BusScheduler_Poll(BusScheduler* bus);
+
+/**
+ * @brief Bus utilization since the last reset
+ *
+ * @param [in] bus
+ * @return busy time per mille of elapsed time
+ */
+uint16_t BusScheduler_Utilization(const BusScheduler* bus);
+
+/**
+ * @brief Restart utilization and sample counters
+ *
+ * @param [out] bus
+ */
+void BusScheduler_Reset_Stats(BusScheduler* bus);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* BUSSCHEDULER_H_ */
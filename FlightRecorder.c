@@ -0,0 +1,175 @@
+/**
+ * @file FlightRecorder.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the raw sample flight recorder, and related variables, methods
+ *
+ * The FlightRecorder object keeps the latest raw PS/ALS samples in a ring of fixed-size blocks held in SRAM.
+ * Each block opens with a keyframe (time, sample period, full PS and ALS values) followed by one byte per
+ * sample holding both deltas as signed nibbles; a delta outside [-7, 7] is escaped and its full 16-bit value
+ * follows. A sample more than half a period off the block's timeline opens a new block, so decoded times
+ * stay within half a period of the recorded ones across period changes and gaps. Blocks decode
+ * independently, so overwriting the oldest block never breaks the remaining history.
+ * On a trigger the recorder keeps going for a number of post-trigger samples, then freezes until re-armed.
+ */
+
+
+#include "FlightRecorder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Check delta fits in a signed nibble without clashing with #FR_ESCAPE */
+#define FR_FITS_NIBBLE(DELTA) (((DELTA) >= -7) && ((DELTA) <= 7))
+
+void Init_FlightRecorder(FlightRecorder* recorder)
+{
+	FlightRecorder_Rearm(recorder);
+}
+
+void FlightRecorder_Rearm(FlightRecorder* recorder)
+{
+	memset(recorder->blocks, 0, sizeof(recorder->blocks));
+	recorder->head = 0;
+	recorder->used = 0;
+	recorder->offset = 0;
+	recorder->lastPs = 0;
+	recorder->lastAls = 0;
+	recorder->postCount = 0;
+	recorder->triggered = 0;
+	recorder->frozen = 0;
+}
+
+void FlightRecorder_Record(FlightRecorder* recorder, uint32_t time, uint16_t period, uint16_t psVal, uint16_t alsVal)
+{
+	int32_t psDelta, alsDelta, late;
+	uint8_t len;
+	uint8_t* block;
+
+	if (recorder->frozen) return;
+
+	if (period > 255) period = 255;
+
+	psDelta = (int32_t) psVal - recorder->lastPs;
+	alsDelta = (int32_t) alsVal - recorder->lastAls;
+	len = 1 + (FR_FITS_NIBBLE(psDelta) ? 0 : 2) + (FR_FITS_NIBBLE(alsDelta) ? 0 : 2);
+	block = recorder->blocks[recorder->head];
+
+	//	Offset of the sample from the time decoded for it, keyframe time plus a period per sample
+	late = (int32_t) (time - ((uint32_t) block[2] | ((uint32_t) block[3] << 8) | ((uint32_t) block[4] << 16) |
+		((uint32_t) block[5] << 24)) - (uint32_t) block[0] * block[1]);
+
+	//	Open new block with a keyframe when the head is full, the period changed, the sample is more than half
+	//	a period off its decoded time, or nothing is recorded yet
+	if ((recorder->used == 0) || (recorder->offset + len > FR_BLOCK_LEN) || (block[1] != period) || (block[0] == 255) ||
+		(2 * late > period) || (2 * late < -(int32_t) period))
+	{
+		if (recorder->used > 0) recorder->head = (recorder->head + 1) % FR_BLOCKS;
+		if (recorder->used < FR_BLOCKS) recorder->used++;
+
+		block = recorder->blocks[recorder->head];
+		block[0] = 1;
+		block[1] = (uint8_t) period;
+		block[2] = (uint8_t) time;
+		block[3] = (uint8_t) (time >> 8);
+		block[4] = (uint8_t) (time >> 16);
+		block[5] = (uint8_t) (time >> 24);
+		block[6] = (uint8_t) psVal;
+		block[7] = (uint8_t) (psVal >> 8);
+		block[8] = (uint8_t) alsVal;
+		block[9] = (uint8_t) (alsVal >> 8);
+		recorder->offset = FR_HEADER_LEN;
+	}
+	else
+	{
+		//	Delta nibbles, then escaped full values in PS, ALS order
+		block[recorder->offset++] = (uint8_t) (((FR_FITS_NIBBLE(psDelta) ? (psDelta & 0xF) : FR_ESCAPE) << 4) |
+									(FR_FITS_NIBBLE(alsDelta) ? (alsDelta & 0xF) : FR_ESCAPE));
+		if (!FR_FITS_NIBBLE(psDelta))
+		{
+			block[recorder->offset++] = (uint8_t) psVal;
+			block[recorder->offset++] = (uint8_t) (psVal >> 8);
+		}
+		if (!FR_FITS_NIBBLE(alsDelta))
+		{
+			block[recorder->offset++] = (uint8_t) alsVal;
+			block[recorder->offset++] = (uint8_t) (alsVal >> 8);
+		}
+		block[0]++;
+	}
+
+	recorder->lastPs = psVal;
+	recorder->lastAls = alsVal;
+
+	//	Freeze once post-trigger samples are recorded
+	if (recorder->triggered && (--recorder->postCount == 0))
+		recorder->frozen = 1;
+}
+
+void FlightRecorder_Trigger(FlightRecorder* recorder, uint16_t postSamples)
+{
+	if (recorder->triggered) return;
+
+	recorder->triggered = 1;
+	recorder->postCount = postSamples;
+	if (postSamples == 0) recorder->frozen = 1;
+}
+
+const uint8_t* FlightRecorder_Block(const FlightRecorder* recorder, uint8_t n)
+{
+	uint8_t oldest;
+
+	if (n >= recorder->used) return NULL;
+
+	oldest = (recorder->head + FR_BLOCKS - (recorder->used - 1)) % FR_BLOCKS;
+	return recorder->blocks[(oldest + n) % FR_BLOCKS];
+}
+
+uint8_t FlightRecorder_Decode(const uint8_t* block, FrSampleCallback callback, void* ctx)
+{
+	uint8_t i, nibble, offset, count = block[0], period = block[1];
+	uint32_t time;
+	uint16_t psVal, alsVal;
+
+	if (count == 0) return 0;
+
+	time = (uint32_t) block[2] | ((uint32_t) block[3] << 8) | ((uint32_t) block[4] << 16) | ((uint32_t) block[5] << 24);
+	psVal = (uint16_t) block[6] | ((uint16_t) block[7] << 8);
+	alsVal = (uint16_t) block[8] | ((uint16_t) block[9] << 8);
+	callback(ctx, time, psVal, alsVal);
+
+	offset = FR_HEADER_LEN;
+	for (i = 1; i < count; i++)
+	{
+		//	Sign extend nibbles, escaped values follow in PS, ALS order
+		uint8_t record = block[offset++];
+
+		nibble = record >> 4;
+		if (nibble == FR_ESCAPE)
+		{
+			psVal = (uint16_t) block[offset] | ((uint16_t) block[offset + 1] << 8);
+			offset += 2;
+		}
+		else
+			psVal += (int8_t) (nibble << 4) >> 4;
+
+		nibble = record & 0xF;
+		if (nibble == FR_ESCAPE)
+		{
+			alsVal = (uint16_t) block[offset] | ((uint16_t) block[offset + 1] << 8);
+			offset += 2;
+		}
+		else
+			alsVal += (int8_t) (nibble << 4) >> 4;
+
+		time += period;
+		callback(ctx, time, psVal, alsVal);
+	}
+
+	return count;
+}
+
+#ifdef __cplusplus
+}
+#endif
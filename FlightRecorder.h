@@ -0,0 +1,141 @@
+/**
+ * @file FlightRecorder.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the raw sample flight recorder, and related variables, methods
+ *
+ * The FlightRecorder object keeps the latest raw PS/ALS samples in a ring of fixed-size blocks held in SRAM.
+ * Each block opens with a keyframe (time, sample period, full PS and ALS values) followed by one byte per
+ * sample holding both deltas as signed nibbles; a delta outside [-7, 7] is escaped and its full 16-bit value
+ * follows. A sample more than half a period off the block's timeline opens a new block, so decoded times
+ * stay within half a period of the recorded ones across period changes and gaps. Blocks decode
+ * independently, so overwriting the oldest block never breaks the remaining history.
+ * On a trigger the recorder keeps going for a number of post-trigger samples, then freezes until re-armed.
+ */
+
+#ifndef FLIGHTRECORDER_H_
+#define FLIGHTRECORDER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#ifdef __GNUC__			/* GNU Compiler Test */
+#include <stdint.h>
+#else
+#include <PE_Types.h>
+#endif
+
+/** @brief Size of a block in bytes */
+#ifndef FR_BLOCK_LEN
+#define FR_BLOCK_LEN 64
+#endif
+
+/** @brief Number of blocks in the ring */
+#ifndef FR_BLOCKS
+#define FR_BLOCKS 6
+#endif
+
+/** @brief Size of the block header: count, period, time, PS and ALS keyframe */
+#define FR_HEADER_LEN 10
+
+/** @brief Nibble value escaping a delta that does not fit in a nibble */
+#define FR_ESCAPE 0x8
+
+/**
+ * @brief Decoded sample callback
+ */
+typedef void (*FrSampleCallback)(void* ctx, uint32_t time, uint16_t psVal, uint16_t alsVal);
+
+/**
+ * @struct FlightRecorder_t
+ * @brief Block ring and recording state
+ */
+typedef struct FlightRecorder_t
+{
+	/** @brief Block ring, each block: count, period (ms), time (ms, LE), PS, ALS (LE), records */
+	uint8_t blocks[FR_BLOCKS][FR_BLOCK_LEN];
+
+	/** @brief Block being written */
+	uint8_t head;
+
+	/** @brief Number of blocks holding samples */
+	uint8_t used;
+
+	/** @brief Write offset within the head block */
+	uint8_t offset;
+
+	/** @brief Latest recorded PS value */
+	uint16_t lastPs;
+
+	/** @brief Latest recorded ALS value */
+	uint16_t lastAls;
+
+	/** @brief Samples still recorded after a trigger, 0 if not triggered */
+	uint16_t postCount;
+
+	/** @brief Flag for a triggered recorder */
+	uint8_t triggered;
+
+	/** @brief Flag for a frozen recorder, set once the post-trigger samples are recorded */
+	uint8_t frozen;
+} FlightRecorder;
+
+/**
+ * @brief Initialize empty, armed recorder
+ *
+ * @param [out] recorder
+ */
+void Init_FlightRecorder(FlightRecorder* recorder);
+
+/**
+ * @brief Record raw sample, no-op while frozen
+ *
+ * @param [out] recorder
+ * @param [in] time acquisition time (in ms)
+ * @param [in] period sampling period the sample was taken at (in ms, saturates at 255)
+ * @param [in] psVal
+ * @param [in] alsVal
+ */
+void FlightRecorder_Record(FlightRecorder* recorder, uint32_t time, uint16_t period, uint16_t psVal, uint16_t alsVal);
+
+/**
+ * @brief Trigger freeze after a number of further samples, ignored if already triggered
+ *
+ * @param [out] recorder
+ * @param [in] postSamples
+ */
+void FlightRecorder_Trigger(FlightRecorder* recorder, uint16_t postSamples);
+
+/**
+ * @brief Discard history and re-arm recorder
+ *
+ * @param [out] recorder
+ */
+void FlightRecorder_Rearm(FlightRecorder* recorder);
+
+/**
+ * @brief Block at a position in recording order
+ *
+ * @param [in] recorder
+ * @param [in] n 0 is the oldest block
+ * @return block, or NULL if n is past the recorded blocks
+ */
+const uint8_t* FlightRecorder_Block(const FlightRecorder* recorder, uint8_t n);
+
+/**
+ * @brief Decode a block
+ *
+ * @param [in] block
+ * @param [in] callback called for every sample in order
+ * @param [in] ctx
+ * @return number of samples decoded
+ */
+uint8_t FlightRecorder_Decode(const uint8_t* block, FrSampleCallback callback, void* ctx);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* FLIGHTRECORDER_H_ */
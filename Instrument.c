@@ -0,0 +1,78 @@
+/**
+ * @file Instrument.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for execution time and jitter instrumentation, and related variables, methods
+ *
+ * Probes record execution time and start jitter into fixed-size log2 histograms. All macros compile to
+ * nothing unless INSTRUMENT is defined, which _DEBUG builds do by default, so release builds carry neither
+ * the histogram storage nor the clock reads.
+ */
+
+
+#include "Instrument.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef INSTRUMENT
+
+InstrStats instrStats[PROBE_COUNT];
+InstrClock instrClock;
+
+/**
+ * @brief Map value to log2 histogram bin
+ *
+ * @param [in] value
+ * @return bin index
+ */
+static uint8_t Instrument_Bin(uint32_t value)
+{
+	uint8_t bin = 0;
+
+	while ((value != 0) && (bin < INSTR_HIST_BINS - 1))
+	{
+		value >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+
+void Init_Instrument(InstrClock clock)
+{
+	instrClock = clock;
+	Reset_Instrument();
+}
+
+void Reset_Instrument(void)
+{
+	memset(instrStats, 0, PROBE_COUNT * sizeof(InstrStats));
+}
+
+void Instrument_Record_Exec(InstrProbe probe, uint32_t exec)
+{
+	InstrStats* stats = &instrStats[probe];
+	uint8_t bin = Instrument_Bin(exec);
+
+	if (stats->execHist[bin] != UINT16_MAX) stats->execHist[bin]++;
+	if (exec > UINT16_MAX) exec = UINT16_MAX;
+	if (exec > stats->maxExec) stats->maxExec = (uint16_t) exec;
+}
+
+void Instrument_Record_Jitter(InstrProbe probe, uint32_t jitter)
+{
+	InstrStats* stats = &instrStats[probe];
+	uint8_t bin = Instrument_Bin(jitter);
+
+	if (stats->jitterHist[bin] != UINT16_MAX) stats->jitterHist[bin]++;
+	if (jitter > UINT16_MAX) jitter = UINT16_MAX;
+	if (jitter > stats->maxJitter) stats->maxJitter = (uint16_t) jitter;
+}
+
+#endif /* INSTRUMENT */
+
+#ifdef __cplusplus
+}
+#endif
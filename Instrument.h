@@ -0,0 +1,131 @@
+/**
+ * @file Instrument.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for execution time and jitter instrumentation, and related variables, methods
+ *
+ * Probes record execution time and start jitter into fixed-size log2 histograms. All macros compile to
+ * nothing unless INSTRUMENT is defined, which _DEBUG builds do by default, so release builds carry neither
+ * the histogram storage nor the clock reads.
+ */
+
+#ifndef INSTRUMENT_H_
+#define INSTRUMENT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#ifdef __GNUC__			/* GNU Compiler Test */
+#include <stdint.h>
+#else
+#include <PE_Types.h>
+#endif
+
+#if defined(_DEBUG) && !defined(INSTRUMENT)
+#define INSTRUMENT
+#endif
+
+/** @brief Number of log2 histogram bins, bin n holds values in [2^(n-1), 2^n), last bin saturates */
+#define INSTR_HIST_BINS 12
+
+/**
+ * @brief Instrumented code sections
+ */
+typedef enum InstrProbe_t
+{
+	PROBE_SENSOR_QUERY = 0,
+	PROBE_ALS_QUERY,
+	PROBE_PROCESS_QUERY,
+	PROBE_LED_UPDATE,
+	PROBE_SERIAL_QUERY,
+	PROBE_CHANGE_COLOUR,
+	PROBE_UPDATE_SENSOR_PS,
+	PROBE_UPDATE_SENSOR_ALS,
+	PROBE_DISTANCE_LOOKUP,
+	PROBE_COUNT
+} InstrProbe;
+
+/**
+ * @brief Time source for the instrumentation in microseconds
+ */
+typedef uint32_t (*InstrClock)(void);
+
+/**
+ * @struct InstrStats_t
+ * @brief Execution time and start jitter histograms of a single probe
+ */
+typedef struct InstrStats_t
+{
+	/** @brief Execution time histogram, saturating counts */
+	uint16_t execHist[INSTR_HIST_BINS];
+
+	/** @brief Start jitter histogram, saturating counts */
+	uint16_t jitterHist[INSTR_HIST_BINS];
+
+	/** @brief Maximum execution time (in us) */
+	uint16_t maxExec;
+
+	/** @brief Maximum start jitter (in us) */
+	uint16_t maxJitter;
+} InstrStats;
+
+#ifdef INSTRUMENT
+
+/** @brief Probe statistics, indexed by #InstrProbe */
+extern InstrStats instrStats[PROBE_COUNT];
+
+/** @brief Time source used by the probes */
+extern InstrClock instrClock;
+
+/** @brief Start timing a probe within the current scope */
+#define INSTR_BEGIN(PROBE) uint32_t _instrStart_##PROBE = instrClock()
+
+/** @brief Stop timing a probe started by #INSTR_BEGIN in the same scope */
+#define INSTR_END(PROBE) Instrument_Record_Exec(PROBE, instrClock() - _instrStart_##PROBE)
+
+/** @brief Record start jitter of a probe (in us) */
+#define INSTR_JITTER(PROBE, JITTER) Instrument_Record_Jitter(PROBE, JITTER)
+
+/**
+ * @brief Initialize instrumentation, clearing all histograms
+ *
+ * @param [in] clock
+ */
+void Init_Instrument(InstrClock clock);
+
+/**
+ * @brief Clear all histograms
+ */
+void Reset_Instrument(void);
+
+/**
+ * @brief Record execution time of a probe
+ *
+ * @param [in] probe
+ * @param [in] exec (in us)
+ */
+void Instrument_Record_Exec(InstrProbe probe, uint32_t exec);
+
+/**
+ * @brief Record start jitter of a probe
+ *
+ * @param [in] probe
+ * @param [in] jitter (in us)
+ */
+void Instrument_Record_Jitter(InstrProbe probe, uint32_t jitter);
+
+#else
+
+#define INSTR_BEGIN(PROBE)
+#define INSTR_END(PROBE)
+#define INSTR_JITTER(PROBE, JITTER)
+
+#endif /* INSTRUMENT */
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* INSTRUMENT_H_ */
@@ -0,0 +1,66 @@
+/**
+ * @file PsPipeline.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the pipelined PS trigger/read timing model, and related variables, methods
+ *
+ * In active force mode each PS sample needs a trigger followed by a conversion. The PsPipeline object tracks
+ * a single conversion in flight so a sample can read the previous conversion's result, then trigger the
+ * next one, and process while the sensor integrates. It records the effective age of every result and
+ * counts reads issued before the conversion time had elapsed.
+ */
+
+
+#include "PsPipeline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Init_PsPipeline(PsPipeline* pipeline, uint32_t conversionTime)
+{
+	pipeline->conversionTime = conversionTime;
+	pipeline->triggerTime = 0;
+	pipeline->pending = 0;
+	pipeline->readCount = 0;
+	pipeline->earlyCount = 0;
+	pipeline->lastAge = 0;
+	pipeline->maxAge = 0;
+}
+
+void PsPipeline_Trigger(PsPipeline* pipeline, uint32_t now)
+{
+	pipeline->triggerTime = now;
+	pipeline->pending = 1;
+}
+
+uint8_t PsPipeline_Read(PsPipeline* pipeline, uint32_t now)
+{
+	uint32_t age;
+
+	if (!pipeline->pending) return 0;
+
+	age = now - pipeline->triggerTime;
+	pipeline->pending = 0;
+	pipeline->readCount++;
+	pipeline->lastAge = age;
+	if (age > pipeline->maxAge) pipeline->maxAge = age;
+
+	//	Result register still holds the previous conversion
+	if (age < pipeline->conversionTime)
+	{
+		pipeline->earlyCount++;
+		return 0;
+	}
+
+	return 1;
+}
+
+uint8_t PsPipeline_Ready(const PsPipeline* pipeline, uint32_t now)
+{
+	return pipeline->pending && ((now - pipeline->triggerTime) >= pipeline->conversionTime);
+}
+
+#ifdef __cplusplus
+}
+#endif
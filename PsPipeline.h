@@ -0,0 +1,92 @@
+/**
+ * @file PsPipeline.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the pipelined PS trigger/read timing model, and related variables, methods
+ *
+ * In active force mode each PS sample needs a trigger followed by a conversion. The PsPipeline object tracks
+ * a single conversion in flight so a sample can read the previous conversion's result, then trigger the
+ * next one, and process while the sensor integrates. It records the effective age of every result and
+ * counts reads issued before the conversion time had elapsed.
+ */
+
+#ifndef PSPIPELINE_H_
+#define PSPIPELINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __GNUC__			/* GNU Compiler Test */
+#include <stdint.h>
+#else
+#include <PE_Types.h>
+#endif
+
+/**
+ * @struct PsPipeline_t
+ * @brief Conversion in flight and sample age statistics
+ */
+typedef struct PsPipeline_t
+{
+	/** @brief Expected conversion time after a trigger (in us) */
+	uint32_t conversionTime;
+
+	/** @brief Time of the trigger of the conversion in flight (in us) */
+	uint32_t triggerTime;
+
+	/** @brief Flag for a conversion in flight */
+	uint8_t pending;
+
+	/** @brief Number of results read */
+	uint32_t readCount;
+
+	/** @brief Number of results read before the conversion time had elapsed */
+	uint32_t earlyCount;
+
+	/** @brief Age of the latest result, time from its trigger to its read (in us) */
+	uint32_t lastAge;
+
+	/** @brief Maximum result age (in us) */
+	uint32_t maxAge;
+} PsPipeline;
+
+/**
+ * @brief Initialize pipeline with no conversion in flight
+ *
+ * @param [out] pipeline
+ * @param [in] conversionTime (in us)
+ */
+void Init_PsPipeline(PsPipeline* pipeline, uint32_t conversionTime);
+
+/**
+ * @brief Record trigger of a new conversion
+ *
+ * @param [out] pipeline
+ * @param [in] now (in us)
+ */
+void PsPipeline_Trigger(PsPipeline* pipeline, uint32_t now);
+
+/**
+ * @brief Record read of the conversion in flight
+ *
+ * @param [out] pipeline
+ * @param [in] now (in us)
+ * @return 1 if a conversion was in flight and its result is valid, otherwise 0
+ */
+uint8_t PsPipeline_Read(PsPipeline* pipeline, uint32_t now);
+
+/**
+ * @brief Check whether the conversion in flight has had its conversion time
+ *
+ * @param [in] pipeline
+ * @param [in] now (in us)
+ * @return 1 if a conversion is in flight and complete, otherwise 0
+ */
+uint8_t PsPipeline_Ready(const PsPipeline* pipeline, uint32_t now);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* PSPIPELINE_H_ */
@@ -0,0 +1,88 @@
+/**
+ * @file RateControl.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the adaptive sampling rate controller, and related variables, methods
+ *
+ * The RateControl object selects the sensor sampling period from proximity activity. The sensor is sampled
+ * at a slow idle period while nothing is near and the PS window is flat, at an intermediate period once PS
+ * rises toward the hysteresis enter threshold, and at the fast active period while in proximity. Speeding
+ * up is immediate, slowing down waits for a number of consecutive quiet samples.
+ */
+
+
+#include <string.h>
+#include "RateControl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Init_RateControl(RateControl* rate, uint32_t activePeriod, uint32_t approachPeriod, uint32_t idlePeriod,
+		uint16_t psApproach, double psFlatSTD, uint16_t quietSamples)
+{
+	rate->period[RATE_ACTIVE] = activePeriod;
+	rate->period[RATE_APPROACH] = approachPeriod;
+	rate->period[RATE_IDLE] = idlePeriod;
+	rate->psApproach = psApproach;
+	rate->psFlatSTD = psFlatSTD;
+	rate->quietSamples = quietSamples;
+	rate->quietCount = 0;
+	rate->level = RATE_ACTIVE;
+	memset(rate->enterCount, 0, sizeof(rate->enterCount));
+}
+
+uint8_t RateControl_Update(RateControl* rate, Sensor* sensor, uint16_t psVal)
+{
+	RateLevel target;
+	int32_t value = psVal;
+	uint16_t psApproach = rate->psApproach ? rate->psApproach : sensor->proxTable[DIST_LOOKUP_LEN - 1];
+
+	//	Thresholds are for compensated PS, as the hysteresis is, so follow the crosstalk baseline
+	value -= sensor->psOffset;
+
+	//	Level demanded by the latest sample alone
+	if (sensor->inProximity || (value >= sensor->psProxMax))
+		target = RATE_ACTIVE;
+	else if ((value >= psApproach) || (sensor->psSTD > rate->psFlatSTD))
+		target = RATE_APPROACH;
+	else
+		target = RATE_IDLE;
+
+	//	Speed up immediately
+	if (target < rate->level)
+	{
+		rate->level = target;
+		rate->enterCount[rate->level]++;
+		rate->quietCount = 0;
+		Restart_Window(sensor);
+		if (sensor->kalman != NULL) Set_Kalman_Period(sensor->kalman, rate->period[rate->level]);
+		return 1;
+	}
+
+	if (target == rate->level)
+	{
+		rate->quietCount = 0;
+		return 0;
+	}
+
+	//	Slow down one level after enough consecutive quiet samples
+	if (++rate->quietCount < rate->quietSamples)
+		return 0;
+
+	rate->level++;
+	rate->enterCount[rate->level]++;
+	rate->quietCount = 0;
+	Restart_Window(sensor);
+	if (sensor->kalman != NULL) Set_Kalman_Period(sensor->kalman, rate->period[rate->level]);
+	return 1;
+}
+
+uint32_t RateControl_Period(const RateControl* rate)
+{
+	return rate->period[rate->level];
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file RateControl.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the adaptive sampling rate controller, and related variables, methods
+ *
+ * The RateControl object selects the sensor sampling period from proximity activity. The sensor is sampled
+ * at a slow idle period while nothing is near and the PS window is flat, at an intermediate period once PS
+ * rises toward the hysteresis enter threshold, and at the fast active period while in proximity. Speeding
+ * up is immediate, slowing down waits for a number of consecutive quiet samples.
+ */
+
+#ifndef RATECONTROL_H_
+#define RATECONTROL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Sensor.h"
+
+/**
+ * @brief Sampling rate levels, from fastest to slowest
+ */
+typedef enum RateLevel_t
+{
+	RATE_ACTIVE = 0,
+	RATE_APPROACH,
+	RATE_IDLE,
+	RATE_LEVEL_COUNT
+} RateLevel;
+
+/**
+ * @struct RateControl_t
+ * @brief Rate controller parameters and state
+ */
+typedef struct RateControl_t
+{
+	/** @brief Sampling period for each #RateLevel (in us) */
+	uint32_t period[RATE_LEVEL_COUNT];
+
+	/** @brief Compensated PS count at or above which sampling leaves #RATE_IDLE, 0 for the sensor's no target end */
+	uint16_t psApproach;
+
+	/** @brief PS STD at or below which the window is considered flat */
+	double psFlatSTD;
+
+	/** @brief Consecutive quiet samples required before slowing down one level */
+	uint16_t quietSamples;
+
+	/** @brief Current quiet sample count */
+	uint16_t quietCount;
+
+	/** @brief Current rate level */
+	RateLevel level;
+
+	/** @brief Number of times each #RateLevel was entered */
+	uint32_t enterCount[RATE_LEVEL_COUNT];
+} RateControl;
+
+/**
+ * @brief Initialize rate controller, starting at #RATE_ACTIVE
+ *
+ * @param [out] rate
+ * @param [in] activePeriod (in us)
+ * @param [in] approachPeriod (in us)
+ * @param [in] idlePeriod (in us)
+ * @param [in] psApproach 0 for the last \ref Sensor.proxTable entry, the PS of the farthest target, which
+ *             stays above the resting PS whatever the crosstalk of a unit
+ * @param [in] psFlatSTD
+ * @param [in] quietSamples
+ */
+void Init_RateControl(RateControl* rate, uint32_t activePeriod, uint32_t approachPeriod, uint32_t idlePeriod,
+		uint16_t psApproach, double psFlatSTD, uint16_t quietSamples);
+
+/**
+ * @brief Update rate level from the latest sensor update
+ *
+ * When the level changes the sensor windows are restarted with Restart_Window(), so every window only
+ * holds samples taken at a single period, and a distance Kalman filter is moved to the new period.
+ *
+ * @param [out] rate
+ * @param [out] sensor
+ * @param [in] psVal latest raw PS value, compensated here by \ref Sensor.psOffset
+ * @return 1 if the sampling period changed, otherwise 0
+ */
+uint8_t RateControl_Update(RateControl* rate, Sensor* sensor, uint16_t psVal);
+
+/**
+ * @brief Current sampling period
+ *
+ * @param [in] rate
+ * @return period (in us)
+ */
+uint32_t RateControl_Period(const RateControl* rate);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* RATECONTROL_H_ */
@@ -0,0 +1,84 @@
+/**
+ * @file RegCache.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the VCNL register shadow cache, and related variables, methods
+ *
+ * The RegCache object shadows the 16-bit command registers of a single VCNLXXXX device. Writes matching the
+ * known register state are skipped, and the self-clearing PS force trigger is issued on top of the shadowed
+ * PS_CONF3 value without disturbing it. Counters track bus writes issued and avoided.
+ */
+
+
+#include "RegCache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Init_RegCache(RegCache* cache, uint8_t address, RegWrite write)
+{
+	cache->address = address;
+	cache->write = write;
+	cache->writeCount = 0;
+	cache->avoidedCount = 0;
+	cache->triggerCount = 0;
+
+	RegCache_Invalidate(cache);
+}
+
+void RegCache_Invalidate(RegCache* cache)
+{
+	memset(cache->regs, 0, REG_CACHE_LEN * sizeof(uint16_t));
+	cache->valid = 0;
+}
+
+uint8_t RegCache_Write(RegCache* cache, uint8_t cmd, uint8_t lsb, uint8_t msb)
+{
+	uint8_t status;
+	uint16_t value = ((uint16_t) msb << 8) | lsb;
+
+	if (cmd >= REG_CACHE_LEN) return cache->write(cache->address, cmd, lsb, msb);
+
+	//	Skip write if device already holds value
+	if ((cache->valid & (1 << cmd)) && (cache->regs[cmd] == value))
+	{
+		cache->avoidedCount++;
+		return 0;
+	}
+
+	status = cache->write(cache->address, cmd, lsb, msb);
+	cache->writeCount++;
+
+	//	Device state unknown after a failed write
+	if (status != 0)
+	{
+		cache->valid &= ~(1 << cmd);
+		return status;
+	}
+
+	cache->regs[cmd] = value;
+	cache->valid |= (1 << cmd);
+	return 0;
+}
+
+uint8_t RegCache_Trigger(RegCache* cache, uint8_t cmd)
+{
+	uint8_t status;
+	uint16_t value;
+
+	//	A shadow never written, or behind a failed write, would not hold the device's configuration
+	if ((cmd >= REG_CACHE_LEN) || !(cache->valid & (1 << cmd))) return REG_CACHE_UNKNOWN;
+
+	value = cache->regs[cmd];
+	status = cache->write(cache->address, cmd, (uint8_t) (value | REG_PS_TRIG), (uint8_t) (value >> 8));
+	cache->writeCount++;
+	cache->triggerCount++;
+
+	//	Shadow stays valid after a failed trigger, the next one writes the whole register again
+	return status;
+}
+
+#ifdef __cplusplus
+}
+#endif
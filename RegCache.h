@@ -0,0 +1,114 @@
+/**
+ * @file RegCache.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the VCNL register shadow cache, and related variables, methods
+ *
+ * The RegCache object shadows the 16-bit command registers of a single VCNLXXXX device. Writes matching the
+ * known register state are skipped, and the self-clearing PS force trigger is issued on top of the shadowed
+ * PS_CONF3 value without disturbing it. Counters track bus writes issued and avoided.
+ */
+
+#ifndef REGCACHE_H_
+#define REGCACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#ifdef __GNUC__			/* GNU Compiler Test */
+#include <stdint.h>
+#else
+#include <PE_Types.h>
+#endif
+
+/** @brief Number of shadowed command codes, 0x00 to 0x0F */
+#define REG_CACHE_LEN 16
+
+/** @brief PS_TRIG bit within PS_CONF3, cleared by the device after a force mode conversion */
+#define REG_PS_TRIG 0x04
+
+/** @brief Status of a trigger on a register with no known device state, nothing written to the bus */
+#define REG_CACHE_UNKNOWN 0xFF
+
+/**
+ * @brief Bus write of one command register, returns 0 on success
+ */
+typedef uint8_t (*RegWrite)(uint8_t address, uint8_t cmd, uint8_t lsb, uint8_t msb);
+
+/**
+ * @struct RegCache_t
+ * @brief Shadow of device command registers and write counters
+ */
+typedef struct RegCache_t
+{
+	/** @brief Device I2C address */
+	uint8_t address;
+
+	/** @brief Bus write function */
+	RegWrite write;
+
+	/** @brief Shadowed register values, MSB in the upper byte */
+	uint16_t regs[REG_CACHE_LEN];
+
+	/** @brief Bit mask of shadowed registers holding known device state */
+	uint16_t valid;
+
+	/** @brief Number of register writes issued on the bus */
+	uint32_t writeCount;
+
+	/** @brief Number of register writes skipped as already matching the device */
+	uint32_t avoidedCount;
+
+	/** @brief Number of force mode triggers issued */
+	uint32_t triggerCount;
+} RegCache;
+
+/**
+ * @brief Initialize register cache with no known device state
+ *
+ * @param [out] cache
+ * @param [in] address
+ * @param [in] write
+ */
+void Init_RegCache(RegCache* cache, uint8_t address, RegWrite write);
+
+/**
+ * @brief Forget known device state, e.g. after a device reset
+ *
+ * @param [out] cache
+ */
+void RegCache_Invalidate(RegCache* cache);
+
+/**
+ * @brief Write command register if it differs from known device state
+ *
+ * @param [out] cache
+ * @param [in] cmd
+ * @param [in] lsb
+ * @param [in] msb
+ * @return 0 on success or skipped write, otherwise bus error
+ */
+uint8_t RegCache_Write(RegCache* cache, uint8_t cmd, uint8_t lsb, uint8_t msb);
+
+/**
+ * @brief Trigger one active force mode PS conversion
+ *
+ * Sets #REG_PS_TRIG on top of the shadowed PS_CONF3/PS_MS value, which must have been written with
+ * RegCache_Write() beforehand. The shadow keeps the trigger bit clear as the device clears it itself.
+ * Without known device state, before that write or after a failed one, nothing is written and the register
+ * has to be written again with RegCache_Write(). A failed trigger keeps the shadow, as the next trigger
+ * writes the whole register again.
+ *
+ * @param [out] cache
+ * @param [in] cmd PS_CONF3/PS_MS command code
+ * @return 0 on success, #REG_CACHE_UNKNOWN without known device state, otherwise bus error
+ */
+uint8_t RegCache_Trigger(RegCache* cache, uint8_t cmd);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* REGCACHE_H_ */
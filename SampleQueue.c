@@ -0,0 +1,70 @@
+/**
+ * @file SampleQueue.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the single-producer/single-consumer raw sample queue, and related variables, methods
+ *
+ * The SampleQueue object decouples acquisition from processing. The producer (sampling task, ISR or I2C
+ * completion) pushes raw timestamped samples and the consumer (main loop) drains them in batches. Head and
+ * tail are free running indices, each written by one side only, so neither side locks or disables
+ * interrupts. A push onto a full queue drops the new sample and counts it.
+ */
+
+
+#include "SampleQueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Init_SampleQueue(SampleQueue* queue)
+{
+	memset(queue->entries, 0, sizeof(queue->entries));
+	queue->head = 0;
+	queue->tail = 0;
+	queue->overflowCount = 0;
+	queue->highWater = 0;
+}
+
+uint8_t SampleQueue_Push(SampleQueue* queue, uint32_t time, uint16_t psVal, uint16_t alsVal, uint8_t channels)
+{
+	QueueIndex head = queue->head;
+	QueueIndex used = (QueueIndex) (head - QUEUE_LOAD(queue->tail));
+	SampleEntry* entry;
+
+	if (used >= SAMPLE_QUEUE_LEN)
+	{
+		queue->overflowCount++;
+		return 0;
+	}
+
+	entry = &queue->entries[head % SAMPLE_QUEUE_LEN];
+	entry->time = time;
+	entry->psVal = psVal;
+	entry->alsVal = alsVal;
+	entry->channels = channels;
+
+	//	Publish entry before the index that makes it visible
+	QUEUE_STORE(queue->head, (QueueIndex) (head + 1));
+
+	if (used + 1 > queue->highWater) queue->highWater = used + 1;
+	return 1;
+}
+
+uint8_t SampleQueue_Pop(SampleQueue* queue, SampleEntry* entries, uint8_t maxCount)
+{
+	QueueIndex tail = queue->tail;
+	QueueIndex available = (QueueIndex) (QUEUE_LOAD(queue->head) - tail);
+	uint8_t i, count = (available < maxCount) ? (uint8_t) available : maxCount;
+
+	for (i = 0; i < count; i++)
+		entries[i] = queue->entries[(QueueIndex) (tail + i) % SAMPLE_QUEUE_LEN];
+
+	//	Release slots only after they are copied out
+	QUEUE_STORE(queue->tail, (QueueIndex) (tail + count));
+	return count;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file SampleQueue.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the single-producer/single-consumer raw sample queue, and related variables, methods
+ *
+ * The SampleQueue object decouples acquisition from processing. The producer (sampling task, ISR or I2C
+ * completion) pushes raw timestamped samples and the consumer (main loop) drains them in batches. Head and
+ * tail are free running indices, each written by one side only, so neither side locks or disables
+ * interrupts. A push onto a full queue drops the new sample and counts it.
+ */
+
+#ifndef SAMPLEQUEUE_H_
+#define SAMPLEQUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#ifdef __GNUC__			/* GNU Compiler Test */
+#include <stdint.h>
+#else
+#include <PE_Types.h>
+#endif
+
+/** @brief Number of queue entries, a power of two, 16 holds about 130 ms of 10 ms PS and 50 ms ALS samples */
+#ifndef SAMPLE_QUEUE_LEN
+#define SAMPLE_QUEUE_LEN 16
+#endif
+
+/** @brief Entry holds a PS value */
+#define SAMPLE_PS 0x01
+
+/** @brief Entry holds an ALS value */
+#define SAMPLE_ALS 0x02
+
+/*
+ * On AVR 8-bit indices are read and written atomically and a compiler barrier orders them, as there is a
+ * single core. Elsewhere indices are 32-bit and use acquire/release atomics.
+ */
+#if defined(__AVR__)
+typedef uint8_t QueueIndex;
+#define QUEUE_LOAD(INDEX) (*(volatile QueueIndex*) &(INDEX))
+#define QUEUE_STORE(INDEX, VALUE) do { __asm__ __volatile__ ("" ::: "memory"); \
+	*(volatile QueueIndex*) &(INDEX) = (VALUE); } while (0)
+#else
+typedef uint32_t QueueIndex;
+#define QUEUE_LOAD(INDEX) __atomic_load_n(&(INDEX), __ATOMIC_ACQUIRE)
+#define QUEUE_STORE(INDEX, VALUE) __atomic_store_n(&(INDEX), (VALUE), __ATOMIC_RELEASE)
+#endif
+
+/**
+ * @struct SampleEntry_t
+ * @brief Raw timestamped sample
+ */
+typedef struct SampleEntry_t
+{
+	/** @brief Acquisition time (in us) */
+	uint32_t time;
+
+	/** @brief Raw PS value, valid with #SAMPLE_PS */
+	uint16_t psVal;
+
+	/** @brief Raw ALS value, valid with #SAMPLE_ALS */
+	uint16_t alsVal;
+
+	/** @brief Channels held, #SAMPLE_PS and/or #SAMPLE_ALS */
+	uint8_t channels;
+} SampleEntry;
+
+/**
+ * @struct SampleQueue_t
+ * @brief Entry ring with producer and consumer indices
+ */
+typedef struct SampleQueue_t
+{
+	/** @brief Entry ring */
+	SampleEntry entries[SAMPLE_QUEUE_LEN];
+
+	/** @brief Next index to push, written by the producer only */
+	QueueIndex head;
+
+	/** @brief Next index to pop, written by the consumer only */
+	QueueIndex tail;
+
+	/** @brief Number of samples dropped on a full queue, written by the producer only */
+	uint32_t overflowCount;
+
+	/** @brief Highest number of queued entries seen by the producer */
+	QueueIndex highWater;
+} SampleQueue;
+
+/**
+ * @brief Initialize empty queue
+ *
+ * @param [out] queue
+ */
+void Init_SampleQueue(SampleQueue* queue);
+
+/**
+ * @brief Push sample, producer side
+ *
+ * @param [out] queue
+ * @param [in] time (in us)
+ * @param [in] psVal
+ * @param [in] alsVal
+ * @param [in] channels
+ * @return 1 if queued, 0 if dropped on a full queue
+ */
+uint8_t SampleQueue_Push(SampleQueue* queue, uint32_t time, uint16_t psVal, uint16_t alsVal, uint8_t channels);
+
+/**
+ * @brief Pop up to a number of samples in push order, consumer side
+ *
+ * @param [out] queue
+ * @param [out] entries
+ * @param [in] maxCount
+ * @return number of samples popped
+ */
+uint8_t SampleQueue_Pop(SampleQueue* queue, SampleEntry* entries, uint8_t maxCount);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SAMPLEQUEUE_H_ */
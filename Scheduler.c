@@ -0,0 +1,168 @@
+/**
+ * @file Scheduler.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the cooperative task scheduler, and related variables, methods
+ *
+ * The Scheduler replaces the equal priority timer.every() callbacks with a small statically allocated task
+ * table. Each task carries a priority and a relative deadline, and only one ready task is run per call to
+ * Scheduler_Run(), so a higher priority task (e.g. sensor sampling) is always picked ahead of a lower
+ * priority one (e.g. serial telemetry) that became ready at the same time. Start jitter, execution time,
+ * deadline misses and overruns are accumulated per task.
+ */
+
+
+#include "Scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Init_Scheduler(Scheduler* sched, SchedClock clock)
+{
+	memset(sched->tasks, 0, SCHED_MAX_TASKS * sizeof(SchedTask));
+	sched->clock = clock;
+	sched->current = SCHED_INVALID_TASK;
+}
+
+int8_t Scheduler_Add(Scheduler* sched, SchedCallback callback, void* arg, uint32_t period, uint32_t deadline, uint8_t priority)
+{
+	int8_t i;
+	SchedTask* task;
+
+	for (i = 0; i < SCHED_MAX_TASKS; i++)
+	{
+		task = &sched->tasks[i];
+		if (task->callback == NULL)
+		{
+			memset(task, 0, sizeof(SchedTask));
+			task->callback = callback;
+			task->arg = arg;
+			task->period = period;
+			task->deadline = (deadline == 0) ? period : deadline;
+			task->priority = priority;
+			task->nextRelease = sched->clock() + period;
+			return i;
+		}
+	}
+
+	// Task table full
+	return SCHED_INVALID_TASK;
+}
+
+void Scheduler_Cancel(Scheduler* sched, int8_t taskId)
+{
+	if ((taskId < 0) || (taskId >= SCHED_MAX_TASKS)) return;
+
+	sched->tasks[taskId].callback = NULL;
+}
+
+void Scheduler_Set_Period(Scheduler* sched, int8_t taskId, uint32_t period)
+{
+	SchedTask* task;
+
+	if ((taskId < 0) || (taskId >= SCHED_MAX_TASKS)) return;
+
+	task = &sched->tasks[taskId];
+	if (task->deadline == task->period) task->deadline = period;
+	task->period = period;
+}
+
+void Scheduler_Release(Scheduler* sched, int8_t taskId)
+{
+	if ((taskId < 0) || (taskId >= SCHED_MAX_TASKS)) return;
+
+	sched->tasks[taskId].nextRelease = sched->clock();
+}
+
+int8_t Scheduler_Run(Scheduler* sched)
+{
+	int8_t i, selected;
+	uint32_t now, start, end, release, jitter, exec;
+	SchedTask* task;
+	SchedTask* best;
+	SchedCallback callback;
+
+	//	Select highest priority ready task, earliest absolute deadline first within a priority
+	now = sched->clock();
+	selected = SCHED_INVALID_TASK;
+	best = NULL;
+	for (i = 0; i < SCHED_MAX_TASKS; i++)
+	{
+		task = &sched->tasks[i];
+		if ((task->callback == NULL) || !SCHED_TIME_REACHED(now, task->nextRelease))
+			continue;
+
+		if ((best == NULL) || (task->priority < best->priority) ||
+			((task->priority == best->priority) &&
+			 !SCHED_TIME_REACHED(task->nextRelease + task->deadline, best->nextRelease + best->deadline)))
+		{
+			best = task;
+			selected = i;
+		}
+	}
+
+	if (best == NULL) return SCHED_INVALID_TASK;
+
+	//	Run task, measuring start jitter and execution time
+	release = best->nextRelease;
+	callback = best->callback;
+	start = sched->clock();
+	jitter = start - release;
+	best->lastJitter = jitter;
+	sched->current = selected;
+	if (!callback(best->arg))
+	{
+		best->callback = NULL;
+	}
+	sched->current = SCHED_INVALID_TASK;
+	end = sched->clock();
+
+	//	Task may have been cancelled and its slot reused from within the callback
+	if ((best->callback != callback) && (best->callback != NULL))
+		return selected;
+
+	exec = end - start;
+
+	best->runCount++;
+	best->jitterSum += jitter;
+	if (jitter > best->maxJitter) best->maxJitter = jitter;
+	best->lastExec = exec;
+	if (exec > best->maxExec) best->maxExec = exec;
+
+	if (!SCHED_TIME_REACHED(release + best->deadline, end))
+		best->missCount++;
+
+	//	Advance release, skipping any periods already passed so a late task does not burst
+	best->nextRelease = release + best->period;
+	while (SCHED_TIME_REACHED(end, best->nextRelease))
+	{
+		best->nextRelease += best->period;
+		best->overrunCount++;
+	}
+
+	return selected;
+}
+
+void Scheduler_Reset_Stats(Scheduler* sched)
+{
+	uint8_t i;
+	SchedTask* task;
+
+	for (i = 0; i < SCHED_MAX_TASKS; i++)
+	{
+		task = &sched->tasks[i];
+		task->runCount = 0;
+		task->missCount = 0;
+		task->overrunCount = 0;
+		task->lastJitter = 0;
+		task->maxJitter = 0;
+		task->jitterSum = 0;
+		task->lastExec = 0;
+		task->maxExec = 0;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
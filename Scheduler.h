@@ -0,0 +1,185 @@
+/**
+ * @file Scheduler.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the cooperative task scheduler, and related variables, methods
+ *
+ * The Scheduler replaces the equal priority timer.every() callbacks with a small statically allocated task
+ * table. Each task carries a priority and a relative deadline, and only one ready task is run per call to
+ * Scheduler_Run(), so a higher priority task (e.g. sensor sampling) is always picked ahead of a lower
+ * priority one (e.g. serial telemetry) that became ready at the same time. Start jitter, execution time,
+ * deadline misses and overruns are accumulated per task.
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#include <stdbool.h>
+#ifdef __GNUC__			/* GNU Compiler Test */
+#include <stdint.h>
+#else
+#include <PE_Types.h>
+#endif
+
+/** @brief Maximum number of tasks held by a scheduler */
+#define SCHED_MAX_TASKS 8
+
+/** @brief Task id returned when a task could not be added */
+#define SCHED_INVALID_TASK -1
+
+/** @brief Wrap-safe check of time a being at or after time b */
+#define SCHED_TIME_REACHED(a, b) (((int32_t) ((uint32_t) (a) - (uint32_t) (b))) >= 0)
+
+/**
+ * @brief Task callback, returning false removes the task from the scheduler
+ */
+typedef bool (*SchedCallback)(void *);
+
+/**
+ * @brief Time source for the scheduler in microseconds
+ */
+typedef uint32_t (*SchedClock)(void);
+
+/**
+ * @struct SchedTask_t
+ * @brief Periodic task entry, its timing parameters and its run statistics
+ */
+typedef struct SchedTask_t
+{
+	/** @brief Task callback, NULL if slot is free */
+	SchedCallback callback;
+
+	/** @brief Argument passed to \ref SchedTask.callback */
+	void* arg;
+
+	/** @brief Task period (in us) */
+	uint32_t period;
+
+	/** @brief Deadline relative to release time (in us) */
+	uint32_t deadline;
+
+	/** @brief Next release time (in us) */
+	uint32_t nextRelease;
+
+	/** @brief Task priority, 0 is the highest */
+	uint8_t priority;
+
+	/** @brief Number of completed runs */
+	uint32_t runCount;
+
+	/** @brief Number of runs finishing after release time + deadline */
+	uint32_t missCount;
+
+	/** @brief Number of releases skipped because the task ran later than its next period */
+	uint32_t overrunCount;
+
+	/** @brief Latest start jitter, time between release and start, set before the callback runs (in us) */
+	uint32_t lastJitter;
+
+	/** @brief Maximum start jitter (in us) */
+	uint32_t maxJitter;
+
+	/** @brief Sum of start jitter over all runs, for mean calculation (in us) */
+	uint32_t jitterSum;
+
+	/** @brief Latest execution time (in us) */
+	uint32_t lastExec;
+
+	/** @brief Maximum execution time (in us) */
+	uint32_t maxExec;
+} SchedTask;
+
+/**
+ * @struct Scheduler_t
+ * @brief Scheduler struct holding the static task table and time source
+ */
+typedef struct Scheduler_t
+{
+	/** @brief Static task table */
+	SchedTask tasks[SCHED_MAX_TASKS];
+
+	/** @brief Time source (in us) */
+	SchedClock clock;
+
+	/** @brief Id of the task being run, #SCHED_INVALID_TASK outside of Scheduler_Run() */
+	int8_t current;
+} Scheduler;
+
+/**
+ * @brief Initialize scheduler with an empty task table
+ *
+ * @param [out] sched
+ * @param [in] clock
+ */
+void Init_Scheduler(Scheduler* sched, SchedClock clock);
+
+/**
+ * @brief Add periodic task, first released one period from now
+ *
+ * @param [out] sched
+ * @param [in] callback
+ * @param [in] arg
+ * @param [in] period (in us)
+ * @param [in] deadline relative to release, 0 uses period (in us)
+ * @param [in] priority 0 is the highest
+ * @return task id, or #SCHED_INVALID_TASK if the task table is full
+ */
+int8_t Scheduler_Add(Scheduler* sched, SchedCallback callback, void* arg, uint32_t period, uint32_t deadline, uint8_t priority);
+
+/**
+ * @brief Remove task from scheduler
+ *
+ * @param [out] sched
+ * @param [in] taskId
+ */
+void Scheduler_Cancel(Scheduler* sched, int8_t taskId);
+
+/**
+ * @brief Change task period
+ * 
+ * Called from the task's own callback, the new period applies from the current release. Otherwise the
+ * already scheduled release is kept and the new period applies after it. A deadline equal to the old
+ * period follows the new period.
+ *
+ * @param [out] sched
+ * @param [in] taskId
+ * @param [in] period (in us)
+ */
+void Scheduler_Set_Period(Scheduler* sched, int8_t taskId, uint32_t period);
+
+/**
+ * @brief Release task now, e.g. when data it waits for arrives
+ *
+ * The task runs as soon as no higher priority task is ready, and its periodic releases continue one period
+ * after this one.
+ *
+ * @param [out] sched
+ * @param [in] taskId
+ */
+void Scheduler_Release(Scheduler* sched, int8_t taskId);
+
+/**
+ * @brief Run the highest priority ready task, ties broken by earliest absolute deadline
+ *
+ * @param [out] sched
+ * @return task id that was run, or #SCHED_INVALID_TASK if no task was ready
+ */
+int8_t Scheduler_Run(Scheduler* sched);
+
+/**
+ * @brief Clear run statistics of every task
+ *
+ * @param [out] sched
+ */
+void Scheduler_Reset_Stats(Scheduler* sched);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SCHEDULER_H_ */
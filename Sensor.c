@@ -11,11 +11,21 @@
 
 
 #include "Sensor.h"
+#include "Instrument.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** @brief Smallest SensorKalman measurement variance, (1/64 cm)^2 */
+#define KALMAN_R_MIN (1L << (SENSOR_KALMAN_COV_BITS - 12))
+
+/** @brief Largest SensorKalman covariance, so sums of a few stay within 32 bits */
+#define KALMAN_COV_MAX (INT32_MAX / 4)
+
 const volatile uint16_t distanceTable[DIST_LOOKUP_LEN] =
 {
 		0,	2,	4,	6,	8,
@@ -24,12 +34,33 @@ const volatile uint16_t distanceTable[DIST_LOOKUP_LEN] =
 		30
 };
 
+/**
+ * @brief 1 / sqrt(u) at the middle of [u, u + 1/64) for u in [0.25, 1), 14 fractional bits
+ */
+static const uint16_t rsqrtSeed[48] =
+{
+		32268,	31332,	30474,	29682,	28949,	28268,	27632,	27038,
+		26481,	25956,	25462,	24994,	24552,	24132,	23733,	23354,
+		22992,	22646,	22315,	21999,	21695,	21404,	21124,	20855,
+		20596,	20346,	20106,	19873,	19649,	19431,	19221,	19018,
+		18821,	18630,	18444,	18264,	18090,	17920,	17755,	17594,
+		17438,	17285,	17137,	16992,	16851,	16714,	16579,	16448
+};
+
 void Init_Sensor(Sensor* sensor, uint8_t index, uint16_t psProxMin, uint16_t psProxMax, uint16_t* proxTable)
 {
 	sensor->index = index;
 	sensor->psProxMin = psProxMin;
 	sensor->psProxMax = psProxMax;
 	sensor->proxTable = proxTable;
+	sensor->distanceModel = NULL;
+	sensor->kalman = NULL;
+	sensor->baseline = NULL;
+	sensor->psSketch = NULL;
+	sensor->alsSketch = NULL;
+	sensor->psFilter = SENSOR_FILTER_RAW;
+	sensor->psWindow = PS_WINDOW;
+	sensor->psFastWindow = PS_FAST_WINDOW;
 	
 	Reset_Sensor(sensor);
 }
@@ -37,129 +68,854 @@ void Init_Sensor(Sensor* sensor, uint8_t index, uint16_t psProxMin, uint16_t psP
 void Reset_Sensor(Sensor* sensor)
 {
 	sensor->sampleCount = 0;
+	sensor->alsSampleCount = 0;
 	sensor->psMean = 0;
 	sensor->psSTD = 0;
 	sensor->alsMean = 0;
 	sensor->alsSTD = 0;
+	sensor->psMin = 0;
+	sensor->psMax = 0;
+	sensor->alsMin = 0;
+	sensor->alsMax = 0;
+	sensor->estimatedVelocity = 0;
+	sensor->distanceSlope = 0;
+	sensor->predictedDistance = 0;
 	sensor->inProximity = 0;
 	sensor->isBlocked = 0;
+	sensor->psOffset = 0;
 	sensor->psWindowSum = 0;
 	sensor->alsWindowSum = 0;
-	memset(sensor->psHist, 0, SENSOR_HIST_LEN * sizeof(uint16_t));
-	memset(sensor->alsHist, 0, SENSOR_HIST_LEN * sizeof(uint16_t));
+	sensor->psFastSum = 0;
+	sensor->distWindowSum = 0;
+	sensor->distWindowMoment = 0;
+	sensor->psWindowFill = 0;
+	sensor->alsWindowFill = 0;
+	memset(&sensor->psHist, 0, sizeof(sensor->psHist));
+	memset(&sensor->alsHist, 0, sizeof(sensor->alsHist));
+#ifdef SENSOR_MINMAX_DEQUE
+	sensor->psMinDeque.count = 0;
+	sensor->psMaxDeque.count = 0;
+	sensor->alsMinDeque.count = 0;
+	sensor->alsMaxDeque.count = 0;
+#endif
+	if (sensor->kalman != NULL) sensor->kalman->started = 0;
+	if (sensor->baseline != NULL) Init_Sensor_Baseline(sensor->baseline, sensor->baseline->reference, sensor->baseline->decimation);
 }
 
-void Update_Sensor(Sensor* sensor, uint16_t psVal, uint16_t alsVal)
+void Restart_Window(Sensor* sensor)
 {
-	uint16_t i, ind, windowInd;
-	double errorSum;
-	double meanDouble;	// Keeps precision when calculating STD
+	sensor->psWindowSum = 0;
+	sensor->psFastSum = 0;
+	sensor->distWindowSum = 0;
+	sensor->distWindowMoment = 0;
+	sensor->psWindowFill = 0;
+#ifdef SENSOR_MINMAX_DEQUE
+	sensor->psMinDeque.count = 0;
+	sensor->psMaxDeque.count = 0;
+#endif
+}
+
+void Set_PS_Window(Sensor* sensor, uint8_t window)
+{
+	if (window < 1) window = 1;
+	if (window > SENSOR_HIST_LEN) window = SENSOR_HIST_LEN;
+	
+	sensor->psWindow = window;
+	Restart_Window(sensor);
+}
+
+void Set_PS_Fast_Window(Sensor* sensor, uint8_t window)
+{
+	if (window < 1) window = 1;
+	if (window > SENSOR_HIST_LEN) window = SENSOR_HIST_LEN;
+	
+	sensor->psFastWindow = window;
+	Restart_Window(sensor);
+}
+
+void Set_Distance_Model(Sensor* sensor, const SensorModel* model)
+{
+	sensor->distanceModel = model;
+	Restart_Window(sensor);
+}
+
+void Set_Distance_Kalman(Sensor* sensor, SensorKalman* kalman)
+{
+	sensor->kalman = kalman;
+	sensor->estimatedVelocity = 0;
+	if (kalman != NULL) kalman->started = 0;
+}
+
+void Set_PS_Baseline(Sensor* sensor, SensorBaseline* baseline)
+{
+	sensor->baseline = baseline;
+	if (sensor->psOffset != 0) Restart_Window(sensor);
+	sensor->psOffset = 0;
+}
+
+void Set_Sensor_Sketch(Sensor* sensor, SensorSketch* psSketch, SensorSketch* alsSketch)
+{
+	sensor->psSketch = psSketch;
+	sensor->alsSketch = alsSketch;
+}
+
+/**
+ * @brief PS value with the baseline drift removed, as the thresholds and proximity table expect
+ * 
+ * @param [in] sensor
+ * @param [in] psVal
+ * @return psVal - \ref Sensor.psOffset, within [0, 65535]
+ */
+static uint16_t Compensate_PS(const Sensor* sensor, uint16_t psVal)
+{
+	int32_t value = (int32_t) psVal - sensor->psOffset;
+	
+	if (value < 0) return 0;
+	return (value > UINT16_MAX) ? UINT16_MAX : (uint16_t) value;
+}
+
+/**
+ * @brief Distance of a single PS value, from the distance model or the proximity table
+ * 
+ * @param [in] sensor
+ * @param [in] psVal
+ * @return distance (in cm)
+ */
+static double Sample_Distance(const Sensor* sensor, uint16_t psVal)
+{
+	psVal = Compensate_PS(sensor, psVal);
+	if (sensor->distanceModel != NULL) return Distance_Model(psVal, sensor->distanceModel);
+	return Distance_Lookup(psVal, sensor->proxTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN);
+}
+
+/**
+ * @brief Clamp a covariance to #KALMAN_COV_MAX
+ * 
+ * @param [in] value
+ * @return clamped value
+ */
+static int32_t Kalman_Clamp(int64_t value)
+{
+	if (value > KALMAN_COV_MAX) return KALMAN_COV_MAX;
+	return (value < -KALMAN_COV_MAX) ? -KALMAN_COV_MAX : (int32_t) value;
+}
+
+/**
+ * @brief Kalman filter step with a raw PS sample
+ * 
+ * @param [out] sensor
+ * @param [in] psVal
+ */
+static void Update_Kalman(Sensor* sensor, uint16_t psVal)
+{
+	SensorKalman* kalman = sensor->kalman;
+	uint16_t noisy = (psVal > UINT16_MAX - kalman->psNoise) ? UINT16_MAX : psVal + kalman->psNoise;
+	double measured, spread;
+	int32_t z, r, s, k0, y;
+	int64_t k1, speed;
+	
+	//	Measured distance, its variance from the distance change of one noise deviation
+	measured = Sample_Distance(sensor, psVal);
+	spread = measured - Sample_Distance(sensor, noisy);
+	
+	z = (int32_t) (measured * (1L << SENSOR_KALMAN_STATE_BITS));
+	r = Kalman_Clamp((int64_t) (spread * spread * (1L << SENSOR_KALMAN_COV_BITS)));
+	if (r < KALMAN_R_MIN) r = KALMAN_R_MIN;
+	
+	if (!kalman->started)
+	{
+		//	At rest at the first measurement, velocity within SENSOR_KALMAN_SPEED
+		speed = ((int64_t) SENSOR_KALMAN_SPEED * kalman->period << SENSOR_KALMAN_STATE_BITS) / 1000000;
+		kalman->distance = z;
+		kalman->velocity = 0;
+		kalman->p00 = r;
+		kalman->p01 = 0;
+		kalman->p11 = Kalman_Clamp((speed * speed) >> (2 * SENSOR_KALMAN_STATE_BITS - SENSOR_KALMAN_COV_BITS));
+		kalman->started = 1;
+		return;
+	}
+	
+	//	Predict one sample ahead, constant velocity with a random acceleration
+	kalman->distance += kalman->velocity;
+	kalman->p00 = Kalman_Clamp((int64_t) kalman->p00 + 2 * (int64_t) kalman->p01 + kalman->p11 + kalman->q / 4);
+	kalman->p01 = Kalman_Clamp((int64_t) kalman->p01 + kalman->p11 + kalman->q / 2);
+	kalman->p11 = Kalman_Clamp((int64_t) kalman->p11 + kalman->q);
+	
+	//	Correct with the measurement, gains with SENSOR_KALMAN_COV_BITS fractional bits
+	s = kalman->p00 + r;
+	k0 = (int32_t) (((int64_t) kalman->p00 << SENSOR_KALMAN_COV_BITS) / s);
+	k1 = ((int64_t) kalman->p01 << SENSOR_KALMAN_COV_BITS) / s;
+	y = z - kalman->distance;
+	
+	kalman->distance += (int32_t) (((int64_t) k0 * y) >> SENSOR_KALMAN_COV_BITS);
+	kalman->velocity += (int32_t) ((k1 * y) >> SENSOR_KALMAN_COV_BITS);
+	kalman->p11 = Kalman_Clamp(kalman->p11 - ((k1 * kalman->p01) >> SENSOR_KALMAN_COV_BITS));
+	kalman->p01 = (int32_t) (((int64_t) ((1L << SENSOR_KALMAN_COV_BITS) - k0) * kalman->p01) >> SENSOR_KALMAN_COV_BITS);
+	kalman->p00 = (int32_t) (((int64_t) ((1L << SENSOR_KALMAN_COV_BITS) - k0) * kalman->p00) >> SENSOR_KALMAN_COV_BITS);
+}
+
+/**
+ * @brief Update isBlocked flag from latest proximity, ALS state
+ * 
+ * @param [out] sensor
+ */
+static void Update_Blocked(Sensor* sensor)
+{
+	if (!sensor->isBlocked && sensor->inProximity && (sensor->alsMax == 0))
+	{
+		sensor->isBlocked = 1;
+	}
+	else if (sensor->isBlocked && !sensor->inProximity)
+	{
+		sensor->isBlocked = 0;
+	}
+}
+
+#ifdef SENSOR_COMPRESSED_HIST
+/**
+ * @brief Whether the delta stored at sample position is escaped
+ * 
+ * @param [in] hist
+ * @param [in] pos
+ * @return 1 if its high byte is in the escape ring, 0 otherwise
+ */
+static uint8_t Hist_Escaped(const SensorHist* hist, uint32_t pos)
+{
+	uint8_t ind = pos % SENSOR_HIST_LEN;
+	
+	return (hist->escaped[ind >> 3] >> (ind & 7)) & 1;
+}
+
+/**
+ * @brief Append value to compressed history at sample position
+ * 
+ * @param [out] hist
+ * @param [in] pos sample position of the new value
+ * @param [in] value
+ * @return 1 if stored, 0 if its delta needs an escape and the escape ring is full
+ */
+static uint8_t Hist_Push(SensorHist* hist, uint32_t pos, uint16_t value)
+{
+	uint8_t ind = pos % SENSOR_HIST_LEN;
+	uint8_t bit = 1 << (ind & 7);
+	uint16_t delta = value - hist->newest;
+	
+	if (((int16_t) delta >= INT8_MIN) && ((int16_t) delta <= INT8_MAX))
+	{
+		hist->escaped[ind >> 3] &= ~bit;
+	}
+	else
+	{
+		if (hist->escCount >= SENSOR_HIST_ESC_LEN) return 0;
+		
+		hist->escaped[ind >> 3] |= bit;
+		hist->escape[hist->escHead] = delta >> 8;
+		hist->escHead = (hist->escHead + 1) % SENSOR_HIST_ESC_LEN;
+		hist->escCount++;
+	}
+	
+	hist->delta[ind] = (int8_t) delta;
+	hist->newest = value;
+	return 1;
+}
+
+/**
+ * @brief Free the escape of the sample at position, once it left the longest window
+ * 
+ * @param [out] hist
+ * @param [in] pos
+ */
+static void Hist_Release(SensorHist* hist, uint32_t pos)
+{
+	if (Hist_Escaped(hist, pos)) hist->escCount--;
+}
+
+/**
+ * @brief Delta stored at sample position, walking escapes with a slot cursor
+ * 
+ * @param [in] hist
+ * @param [in] pos
+ * @param [in, out] esc escape slot, advanced past the delta when walking forward
+ * @param [in] forward
+ * @return delta modulo 2^16
+ */
+static uint16_t Hist_Delta(const SensorHist* hist, uint32_t pos, uint8_t* esc, uint8_t forward)
+{
+	int8_t low = hist->delta[pos % SENSOR_HIST_LEN];
+	uint8_t high;
+	
+	if (!Hist_Escaped(hist, pos)) return (uint16_t) (int16_t) low;
+	
+	if (forward)
+	{
+		high = hist->escape[*esc];
+		*esc = (*esc + 1) % SENSOR_HIST_ESC_LEN;
+	}
+	else
+	{
+		*esc = (*esc + SENSOR_HIST_ESC_LEN - 1) % SENSOR_HIST_ESC_LEN;
+		high = hist->escape[*esc];
+	}
+	
+	return ((uint16_t) high << 8) | (uint8_t) low;
+}
+
+/**
+ * @brief Start window cursor on the newest sample
+ * 
+ * @param [out] hist
+ */
+static void Hist_Window_Start(SensorHist* hist)
+{
+	hist->tailValue = hist->newest;
+	hist->tailEsc = hist->escHead;
+}
+
+/**
+ * @brief Move window cursor forward onto sample position
+ * 
+ * @param [out] hist
+ * @param [in] pos
+ */
+static void Hist_Window_Advance(SensorHist* hist, uint32_t pos)
+{
+	hist->tailValue += Hist_Delta(hist, pos, &hist->tailEsc, 1);
+}
+#endif /* SENSOR_COMPRESSED_HIST */
+
+#ifdef SENSOR_MINMAX_DEQUE
+/**
+ * @brief Value of a sample held by a monotonic deque
+ * 
+ * @param [in] sensor
+ * @param [in] deque
+ * @param [in] als 1 if the slots index the ALS history, 0 for the PS history
+ * @param [in] k ring index within the deque
+ * @return value
+ */
+static uint16_t Deque_Value(const Sensor* sensor, const SensorDeque* deque, uint8_t als, uint8_t k)
+{
+	return als ? sensor->alsHist[deque->slot[k]] : sensor->psHist[deque->slot[k]];
+}
+
+/**
+ * @brief Push the newest window sample onto a monotonic deque, dropping the sample leaving the window
+ * 
+ * @param [in] sensor history already holding the new sample
+ * @param [out] deque
+ * @param [in] als 1 if the slots index the ALS history, 0 for the PS history
+ * @param [in] slot history slot of the new sample
+ * @param [in] value
+ * @param [in] leaving history slot of the sample leaving a full window, #SENSOR_HIST_LEN if none leaves
+ * @param [in] isMax 1 for a maximum deque, 0 for a minimum
+ * @return window minimum or maximum
+ */
+static uint16_t Deque_Push(const Sensor* sensor, SensorDeque* deque, uint8_t als, uint8_t slot, uint16_t value, uint8_t leaving,
+	uint8_t isMax)
+{
+	uint8_t back, prev;
+	uint16_t held;
+	
+	if ((deque->count > 0) && (deque->slot[deque->head] == leaving))
+	{
+		deque->head = (deque->head + 1 < SENSOR_HIST_LEN) ? deque->head + 1 : 0;
+		deque->count--;
+	}
+	
+	//	Held samples no longer below (above) the new one can never be the extreme again, ring index one
+	//	past the newest wrapped by compare, as SENSOR_HIST_LEN need not be a power of 2
+	back = deque->head + deque->count;
+	if (back >= SENSOR_HIST_LEN) back -= SENSOR_HIST_LEN;
+	while (deque->count > 0)
+	{
+		prev = (back > 0) ? back - 1 : SENSOR_HIST_LEN - 1;
+		held = Deque_Value(sensor, deque, als, prev);
+		if (isMax ? (held > value) : (held < value)) break;
+		back = prev;
+		deque->count--;
+	}
+	
+	deque->slot[back] = slot;
+	deque->count++;
+	
+	return Deque_Value(sensor, deque, als, deque->head);
+}
+#endif /* SENSOR_MINMAX_DEQUE */
 
+/**
+ * @brief Add PS value to the baseline's current block, and move the offset when a block completes
+ * 
+ * Called before the value enters the window, so a restart leaves the window consistent.
+ * 
+ * @param [out] sensor
+ * @param [in] psVal
+ */
+static void Update_Baseline(Sensor* sensor, uint16_t psVal)
+{
+	SensorBaseline* baseline = sensor->baseline;
+	uint16_t lowest[SENSOR_BASELINE_RANK + 1];
+	uint8_t i, j, count = 0;
+	int32_t offset;
+	
+	if (psVal < baseline->currentMin) baseline->currentMin = psVal;
+	if (++baseline->blockFill < baseline->decimation) return;
+	
+	baseline->blockMin[baseline->head] = baseline->currentMin;
+	baseline->head = (baseline->head + 1) % SENSOR_BASELINE_LEN;
+	if (baseline->fill < SENSOR_BASELINE_LEN) baseline->fill++;
+	baseline->currentMin = UINT16_MAX;
+	baseline->blockFill = 0;
+	
+	//	Lowest block minima in order, the last is the baseline, or the highest while there are few blocks
+	for (i = 0; i < baseline->fill; i++)
+	{
+		psVal = baseline->blockMin[i];
+		for (j = count; (j > 0) && (lowest[j - 1] > psVal); j--)
+		{
+			if (j <= SENSOR_BASELINE_RANK) lowest[j] = lowest[j - 1];
+		}
+		if (j <= SENSOR_BASELINE_RANK) lowest[j] = psVal;
+		if (count <= SENSOR_BASELINE_RANK) count++;
+	}
+	
+	baseline->baseline = lowest[count - 1];
+	if (baseline->reference == 0) baseline->reference = baseline->baseline;
+	
+	//	Move the offset only past the deadband, each move restarts the window
+	offset = (int32_t) baseline->baseline - baseline->reference;
+	if (offset > INT16_MAX) offset = INT16_MAX;
+	if (offset < INT16_MIN) offset = INT16_MIN;
+	if ((offset >= sensor->psOffset + SENSOR_BASELINE_DEADBAND) || (offset <= sensor->psOffset - SENSOR_BASELINE_DEADBAND))
+	{
+		sensor->psOffset = (int16_t) offset;
+		Restart_Window(sensor);
+	}
+}
+
+/**
+ * @brief Add the distance of a PS value to the window's least squares sums, dropping the oldest when full
+ * 
+ * Sums are of fixed point distances, so dropping a sample removes exactly what adding it did.
+ * 
+ * @param [out] sensor
+ * @param [in] psVal
+ * @param [in] oldest PS value leaving a full window
+ */
+static void Push_Distance(Sensor* sensor, uint16_t psVal, uint16_t oldest)
+{
+	int32_t distance = (int32_t) (Sample_Distance(sensor, psVal) * 256 + 0.5);
+	
+	if (sensor->psWindowFill < sensor->psWindow)
+	{
+		sensor->distWindowMoment += (int32_t) sensor->psWindowFill * distance;
+	}
+	else
+	{
+		//	Oldest out, every remaining sample one place nearer the oldest, newest in last place
+		sensor->distWindowSum -= (int32_t) (Sample_Distance(sensor, oldest) * 256 + 0.5);
+		sensor->distWindowMoment -= sensor->distWindowSum;
+		sensor->distWindowMoment += (int32_t) (sensor->psWindow - 1) * distance;
+	}
+	
+	sensor->distWindowSum += distance;
+}
+
+/**
+ * @brief Add PS value to the history, rolling window sums, minimum, maximum and sketch
+ * 
+ * @param [out] sensor
+ * @param [in] psVal
+ */
+static void Push_PS(Sensor* sensor, uint16_t psVal)
+{
+#ifdef SENSOR_MINMAX_DEQUE
+	uint8_t slot, leaving;
+#endif
+	
+#ifdef SENSOR_COMPRESSED_HIST
+	uint8_t span = (sensor->psWindow > sensor->psFastWindow) ? sensor->psWindow : sensor->psFastWindow;
+	
+	//	Escapes are live within the longest window only, a restarted window frees them all
+	if (sensor->psWindowFill == 0)
+		sensor->psHist.escCount = 0;
+	else if (sensor->psWindowFill >= span)
+		Hist_Release(&sensor->psHist, sensor->sampleCount - span);
+	
+	//	Escape ring full with a window longer than SENSOR_HIST_ESC_LEN, restart the windows on this sample
+	if (!Hist_Push(&sensor->psHist, sensor->sampleCount, psVal))
+	{
+		Restart_Window(sensor);
+		sensor->psHist.escCount = 0;
+		sensor->psHist.rebaseCount++;
+		Hist_Push(&sensor->psHist, sensor->sampleCount, psVal);
+	}
+	
+	//	Compressed history, window sum from the window cursor
+	if (sensor->psWindowFill == 0) Hist_Window_Start(&sensor->psHist);
+	
+	Push_Distance(sensor, psVal, sensor->psHist.tailValue);
+	if (sensor->psWindowFill < sensor->psWindow)
+	{
+		sensor->psWindowSum += psVal;
+	}
+	else
+	{
+		sensor->psWindowSum -= sensor->psHist.tailValue;
+		sensor->psWindowSum += psVal;
+		Hist_Window_Advance(&sensor->psHist, sensor->sampleCount - sensor->psWindow + 1);
+	}
+	
+	//	Fast window, its own cursor in the same history
+	if (sensor->psWindowFill == 0)
+	{
+		sensor->psFastValue = sensor->psHist.newest;
+		sensor->psFastEsc = sensor->psHist.escHead;
+	}
+	
+	if (sensor->psWindowFill < sensor->psFastWindow)
+	{
+		sensor->psFastSum += psVal;
+	}
+	else
+	{
+		sensor->psFastSum -= sensor->psFastValue;
+		sensor->psFastSum += psVal;
+		sensor->psFastValue += Hist_Delta(&sensor->psHist, sensor->sampleCount - sensor->psFastWindow + 1, &sensor->psFastEsc, 1);
+	}
+#else
+	uint16_t ind, windowInd;
+	
 	//	Update PS rolling window sum
-	if (sensor->sampleCount < PS_WINDOW)
+	windowInd = (sensor->sampleCount - sensor->psWindow) % SENSOR_HIST_LEN;
+	Push_Distance(sensor, psVal, sensor->psHist[windowInd]);
+	if (sensor->psWindowFill < sensor->psWindow)
 	{
 		sensor->psWindowSum += psVal;
 	}
 	else
 	{
-		windowInd = (sensor->sampleCount - PS_WINDOW) % SENSOR_HIST_LEN;
 		sensor->psWindowSum -= sensor->psHist[windowInd];
 		sensor->psWindowSum += psVal;
 	}
+	
+	//	Fast window from the same history, read before the newest sample overwrites it
+	if (sensor->psWindowFill < sensor->psFastWindow)
+	{
+		sensor->psFastSum += psVal;
+	}
+	else
+	{
+		sensor->psFastSum -= sensor->psHist[(sensor->sampleCount - sensor->psFastWindow) % SENSOR_HIST_LEN];
+		sensor->psFastSum += psVal;
+	}
+	
+	// Circular buffer for history
+	ind = sensor->sampleCount % SENSOR_HIST_LEN;
+	sensor->psHist[ind] = psVal;
+#endif
+
+#ifdef SENSOR_MINMAX_DEQUE
+	//	Window minimum, maximum
+	slot = sensor->sampleCount % SENSOR_HIST_LEN;
+	leaving = (slot >= sensor->psWindow) ? slot - sensor->psWindow : slot + SENSOR_HIST_LEN - sensor->psWindow;
+	if (sensor->psWindowFill < sensor->psWindow) leaving = SENSOR_HIST_LEN;
+	sensor->psMin = Deque_Push(sensor, &sensor->psMinDeque, 0, slot, psVal, leaving, 0);
+	sensor->psMax = Deque_Push(sensor, &sensor->psMaxDeque, 0, slot, psVal, leaving, 1);
+#endif
 
+	if (sensor->psSketch != NULL) Sensor_Sketch_Add(sensor->psSketch, psVal);
+}
+
+/**
+ * @brief Add ALS value to the history, rolling window sum, minimum, maximum and sketch
+ * 
+ * @param [out] sensor
+ * @param [in] alsVal
+ */
+static void Push_ALS(Sensor* sensor, uint16_t alsVal)
+{
+#ifdef SENSOR_MINMAX_DEQUE
+	uint8_t slot, leaving;
+#endif
+	
+	uint16_t ind, windowInd;
+	
 	//	Update ALS rolling window sum
-	if (sensor->sampleCount < ALS_WINDOW)
+	if (sensor->alsWindowFill < ALS_WINDOW)
 	{
 		sensor->alsWindowSum += alsVal;
 	}
 	else
 	{
-		windowInd = (sensor->sampleCount - ALS_WINDOW) % SENSOR_HIST_LEN;
+		windowInd = (sensor->alsSampleCount - ALS_WINDOW) % ALS_HIST_LEN;
 		sensor->alsWindowSum += ((int) alsVal) - ((int) sensor->alsHist[windowInd]);
 	}
 	
 	// Circular buffer for history
-	ind = sensor->sampleCount % SENSOR_HIST_LEN;
-	sensor->psHist[ind] = psVal;
+	ind = sensor->alsSampleCount % ALS_HIST_LEN;
 	sensor->alsHist[ind] = alsVal;
 
+#ifdef SENSOR_MINMAX_DEQUE
+	//	Window minimum, maximum
+	slot = sensor->alsSampleCount % SENSOR_HIST_LEN;
+	leaving = (slot >= ALS_WINDOW) ? slot - ALS_WINDOW : slot + SENSOR_HIST_LEN - ALS_WINDOW;
+	if (sensor->alsWindowFill < ALS_WINDOW) leaving = SENSOR_HIST_LEN;
+	sensor->alsMin = Deque_Push(sensor, &sensor->alsMinDeque, 1, slot, alsVal, leaving, 0);
+	sensor->alsMax = Deque_Push(sensor, &sensor->alsMaxDeque, 1, slot, alsVal, leaving, 1);
+#endif
+
+	if (sensor->alsSketch != NULL) Sensor_Sketch_Add(sensor->alsSketch, alsVal);
+}
+
+/**
+ * @brief Update inProximity flag with hysteresis, from the raw PS value or a window mean
+ * 
+ * @param [out] sensor
+ * @param [in] psVal raw value, already in the window
+ * @return 1 if entering into proximity, 0 otherwise
+ */
+static uint8_t Update_Proximity(Sensor* sensor, uint16_t psVal)
+{
+	uint8_t len;
+	
+	if (sensor->psFilter == SENSOR_FILTER_MEAN)
+	{
+		//	Same as psMean, from the window sum alone so batches need no derived fields
+		len = ((sensor->psWindowFill + 1) >= sensor->psWindow) ? sensor->psWindow : sensor->psWindowFill + 1;
+		psVal = sensor->psWindowSum / len;
+	}
+	else if (sensor->psFilter == SENSOR_FILTER_FAST)
+	{
+		len = ((sensor->psWindowFill + 1) >= sensor->psFastWindow) ? sensor->psFastWindow : sensor->psWindowFill + 1;
+		psVal = sensor->psFastSum / len;
+	}
+	
+	psVal = Compensate_PS(sensor, psVal);
+	
+	if (sensor->inProximity && (psVal <= sensor->psProxMin))
+	{
+#ifdef _DEBUG
+		printf("Exiting from proximity at: %d\n", sensor->psMean);
+		printf("Estimated Distance at: %f cm\n", sensor->estimatedDistance);
+#endif
+		sensor->inProximity = 0;
+	}
+	else if (!sensor->inProximity && (psVal >= sensor->psProxMax))
+	{
+#ifdef _DEBUG
+		printf("Entering into proximity at: %d\n", sensor->psMean);
+		printf("Estimated Distance at: %f cm\n", sensor->estimatedDistance);
+#endif
+		sensor->inProximity = 1;
+		return 1;
+	}
+	
+	return 0;
+}
+
+void Update_Sensor(Sensor* sensor, uint16_t psVal, uint16_t alsVal)
+{
+	Update_Sensor_ALS(sensor, alsVal);
+	Update_Sensor_PS(sensor, psVal);
+}
+
+uint16_t Update_Sensor_Batch(Sensor* sensor, const uint16_t* ps, const uint16_t* als, uint16_t n)
+{
+	uint16_t i;
+	uint16_t entries = 0;
+	uint8_t wasInProximity;
+	
+	if (n == 0) return 0;
+	
+	//	ALS first, as Update_Sensor() does for every sample
+	if (als != NULL)
+	{
+		for (i = 0; i < n - 1; i++)
+		{
+			Push_ALS(sensor, als[i]);
+			sensor->alsSampleCount++;
+			if (sensor->alsWindowFill < SENSOR_HIST_LEN) sensor->alsWindowFill++;
+		}
+		
+		//	Derived ALS fields once, from the last sample
+		Update_Sensor_ALS(sensor, als[n - 1]);
+	}
+	
+	if (ps != NULL)
+	{
+		//	Hysteresis and blocked flag on every raw value, so transitions within the batch are not lost
+		for (i = 0; i < n - 1; i++)
+			entries += Update_Sensor_PS_Sample(sensor, ps[i]);
+		
+		//	Derived PS fields once, from the last sample
+		wasInProximity = sensor->inProximity;
+		Update_Sensor_PS(sensor, ps[n - 1]);
+		if (!wasInProximity && sensor->inProximity) entries++;
+	}
+	
+	return entries;
+}
+
+uint8_t Update_Sensor_PS_Sample(Sensor* sensor, uint16_t psVal)
+{
+	uint8_t entering;
+	
+	if (sensor->baseline != NULL) Update_Baseline(sensor, psVal);
+	Push_PS(sensor, psVal);
+	if (sensor->kalman != NULL) Update_Kalman(sensor, psVal);
+	entering = Update_Proximity(sensor, psVal);
+	Update_Blocked(sensor);
+	sensor->sampleCount++;
+	if (sensor->psWindowFill < SENSOR_HIST_LEN) sensor->psWindowFill++;
+	
+	return entering;
+}
+
+void Update_Sensor_PS(Sensor* sensor, uint16_t psVal)
+{
+	uint16_t i;
+	double errorSum;
+	double meanDouble;	// Keeps precision when calculating STD
+	double len, timeSum;
+	uint16_t value;		// History value walked back from the newest sample
+	uint16_t lowest = UINT16_MAX, highest = 0;
+#ifdef SENSOR_COMPRESSED_HIST
+	uint8_t esc;
+#else
+	uint16_t windowInd;
+#endif
+
+	INSTR_BEGIN(PROBE_UPDATE_SENSOR_PS);
+
+	if (sensor->baseline != NULL) Update_Baseline(sensor, psVal);
+	Push_PS(sensor, psVal);
+
 	//	Calculate PS Mean from window sum
-	if ((sensor->sampleCount + 1) >= PS_WINDOW)
-		meanDouble = (double) sensor->psWindowSum / PS_WINDOW;
+	if ((sensor->psWindowFill + 1) >= sensor->psWindow)
+		meanDouble = (double) sensor->psWindowSum / sensor->psWindow;
 	else
-		meanDouble = (double) sensor->psWindowSum / (sensor->sampleCount + 1);
+		meanDouble = (double) sensor->psWindowSum / (sensor->psWindowFill + 1);
 	
 	sensor->psMean = (uint16_t) floor(meanDouble);
 	
-	//	Get estimated distance from PS mean
-	sensor->estimatedDistance = Distance_Lookup(sensor->psMean, sensor->proxTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN);
+	//	Least squares line of the window's distances over places 0 to len - 1, at the newest place
+	len = ((sensor->psWindowFill + 1) >= sensor->psWindow) ? sensor->psWindow : sensor->psWindowFill + 1;
+	timeSum = len * (len - 1) / 2;
+	sensor->distanceSlope = (len > 1) ? (len * sensor->distWindowMoment - timeSum * sensor->distWindowSum) /
+		(len * len * (len * len - 1) / 12) / 256 : 0;
+	sensor->predictedDistance = sensor->distWindowSum / (256 * len) + sensor->distanceSlope * (len - 1) / 2;
+	if (sensor->predictedDistance < distanceTable[0]) sensor->predictedDistance = distanceTable[0];
+	if (sensor->predictedDistance > distanceTable[DIST_LOOKUP_LEN - 1]) sensor->predictedDistance = distanceTable[DIST_LOOKUP_LEN - 1];
 	
-	//	Calculate PS STD
+	//	Get estimated distance from PS mean, or the filter of raw samples
+	{
+		INSTR_BEGIN(PROBE_DISTANCE_LOOKUP);
+		if (sensor->kalman != NULL)
+		{
+			Update_Kalman(sensor, psVal);
+			sensor->estimatedDistance = (double) sensor->kalman->distance / (1L << SENSOR_KALMAN_STATE_BITS);
+			sensor->estimatedVelocity = (double) sensor->kalman->velocity / (1L << SENSOR_KALMAN_STATE_BITS) *
+				1e6 / sensor->kalman->period;
+		}
+		else if (sensor->distanceModel != NULL)
+			sensor->estimatedDistance = Distance_Model(Compensate_PS(sensor, sensor->psMean), sensor->distanceModel);
+		else
+			sensor->estimatedDistance = Distance_Lookup(Compensate_PS(sensor, sensor->psMean), sensor->proxTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN);
+		INSTR_END(PROBE_DISTANCE_LOOKUP);
+	}
+	
+	//	Calculate PS STD, and the window minimum and maximum unless kept by deques
 	errorSum = 0;
-	for (i = 0; i < PS_WINDOW; i++)
+#ifdef SENSOR_COMPRESSED_HIST
+	value = sensor->psHist.newest;
+	esc = sensor->psHist.escHead;
+#endif
+	for (i = 0; i < sensor->psWindow; i++)
 	{
-		if ((((int) sensor->sampleCount) - i) >= 0)
+		if (i <= sensor->psWindowFill)
 		{
+#ifndef SENSOR_COMPRESSED_HIST
 			windowInd = (((int) sensor->sampleCount) - i) % SENSOR_HIST_LEN;
-			errorSum += pow((double)(sensor->psHist[windowInd] - meanDouble), 2);
+			value = sensor->psHist[windowInd];
+#endif
+			errorSum += pow((double)(value - meanDouble), 2);
+			if (value < lowest) lowest = value;
+			if (value > highest) highest = value;
+#ifdef SENSOR_COMPRESSED_HIST
+			value -= Hist_Delta(&sensor->psHist, sensor->sampleCount - i, &esc, 0);
+#endif
 		}
 		else
 			break;
 	}
 	sensor->psSTD = sqrt((double) errorSum / i);
+#ifndef SENSOR_MINMAX_DEQUE
+	sensor->psMin = lowest;
+	sensor->psMax = highest;
+#endif
+
+	//	Update inProximity flag
+	Update_Proximity(sensor, psVal);
+
+	//	Update isBlocked flag
+	Update_Blocked(sensor);
+
+	sensor->sampleCount++;
+	if (sensor->psWindowFill < SENSOR_HIST_LEN) sensor->psWindowFill++;
+
+	INSTR_END(PROBE_UPDATE_SENSOR_PS);
+}
+
+void Update_Sensor_ALS(Sensor* sensor, uint16_t alsVal)
+{
+	uint16_t i;
+	double errorSum;
+	double meanDouble;	// Keeps precision when calculating STD
+	uint16_t value;		// History value walked back from the newest sample
+	uint16_t lowest = UINT16_MAX, highest = 0;
+	uint16_t windowInd;
+
+	INSTR_BEGIN(PROBE_UPDATE_SENSOR_ALS);
+
+	Push_ALS(sensor, alsVal);
 
 	//	Calculate ALS mean from window
-	if (sensor->sampleCount >= ALS_WINDOW - 1)
+	if (sensor->alsWindowFill >= ALS_WINDOW - 1)
 		meanDouble = (double) sensor->alsWindowSum / ALS_WINDOW;
 	else
-		meanDouble = (double) sensor->alsWindowSum / (sensor->sampleCount + 1);
+		meanDouble = (double) sensor->alsWindowSum / (sensor->alsWindowFill + 1);
 	
 	sensor->alsMean = (uint16_t) floor(meanDouble);
 	
-	//	Calculate ALS STD
+	//	Calculate ALS STD, and the window minimum and maximum unless kept by deques
 	errorSum = 0;
 	for (i = 0; i < ALS_WINDOW; i++)
 	{
-		if ((((int) sensor->sampleCount) - i) >= 0)
+		if (i <= sensor->alsWindowFill)
 		{
-			windowInd = (((int) sensor->sampleCount) - i) % SENSOR_HIST_LEN;
-			errorSum += pow((double)(sensor->alsHist[windowInd] - meanDouble), 2);
+			windowInd = (((int) sensor->alsSampleCount) - i) % ALS_HIST_LEN;
+			value = sensor->alsHist[windowInd];
+			errorSum += pow((double)(value - meanDouble), 2);
+			if (value < lowest) lowest = value;
+			if (value > highest) highest = value;
 		}
 		else
 			break;
 	}
 	
 	sensor->alsSTD = sqrt((double) errorSum / i);
-
-	//	Update inProximity flag
-	if (sensor->inProximity && (psVal <= sensor->psProxMin))
-	{
-#ifdef _DEBUG
-		printf("Exiting from proximity at: %d\n", sensor->psMean);
-		printf("Estimated Distance at: %f cm\n", sensor->estimatedDistance);
-#endif
-		sensor->inProximity = 0;
-	}
-	else if (!sensor->inProximity && (psVal >= sensor->psProxMax))
-	{
-#ifdef _DEBUG
-		printf("Entering into proximity at: %d\n", sensor->psMean);
-		printf("Estimated Distance at: %f cm\n", sensor->estimatedDistance);
+#ifndef SENSOR_MINMAX_DEQUE
+	sensor->alsMin = lowest;
+	sensor->alsMax = highest;
 #endif
-		sensor->inProximity = 1;
-	}
 
 	//	Update isBlocked flag
-	if (!sensor->isBlocked && sensor->inProximity && (sensor->alsMean == 0) && (sensor->alsSTD == 0))
-	{
-		sensor->isBlocked = 1;
-	}
-	else if (sensor->isBlocked && !sensor->inProximity)
-	{
-		sensor->isBlocked = 0;
-	}
+	Update_Blocked(sensor);
 
-	sensor->sampleCount++;
+	sensor->alsSampleCount++;
+	if (sensor->alsWindowFill < SENSOR_HIST_LEN) sensor->alsWindowFill++;
+
+	INSTR_END(PROBE_UPDATE_SENSOR_ALS);
 }
 
 double Distance_Lookup(uint16_t psVal, uint16_t* proxTable, uint16_t* distTable, uint8_t tableLen)
@@ -186,6 +942,299 @@ double Distance_Lookup(uint16_t psVal, uint16_t* proxTable, uint16_t* distTable,
 	return (double) distTable[tableLen - 1];
 }
 
+void Distance_Lookup_Batch(const uint16_t* psVals, double* distances, uint32_t n, uint16_t* proxTable, uint16_t* distTable, uint8_t tableLen)
+{
+	uint32_t k;
+#ifdef __SSE2__
+	//	Table in lanes of 8, biased so signed 16 bit compares order unsigned values, plus an empty chunk
+	__m128i chunks[(255 + 7) / 8 + 1];
+	uint32_t laneMask[(255 + 7) / 8 + 1];
+	uint8_t chunkCount = (tableLen + 7) / 8;
+	const __m128i bias = _mm_set1_epi16((short) 0x8000);
+	uint16_t padded[8];
+	uint16_t c, j, i0, i1;
+	uint32_t match;
+	__m128d x, vd;
+	
+	//	Interpolation operands per found index, table ends give a zero fraction
+	double segA[256], segP0[256], segDd[256], segDp[256];
+	
+	for (c = 0; c <= chunkCount; c++)
+	{
+		for (j = 0; j < 8; j++)
+			padded[j] = (c * 8 + j < tableLen) ? proxTable[c * 8 + j] : 0;
+		chunks[c] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) padded), bias);
+		
+		//	movemask gives two bits per 16 bit lane, padding lanes never match
+		j = (c * 8 >= tableLen) ? 0 : ((tableLen - c * 8 < 8) ? tableLen - c * 8 : 8);
+		laneMask[c] = (1UL << (2 * j)) - 1;
+	}
+	
+	for (j = 0; j <= tableLen; j++)
+	{
+		if ((j == 0) || (j == tableLen))
+		{
+			segA[j] = (double) distTable[j ? tableLen - 1 : 0];
+			segP0[j] = 0;
+			segDd[j] = 0;
+			segDp[j] = 1;
+		}
+		else
+		{
+			segA[j] = (double) distTable[j-1];
+			segP0[j] = (double) proxTable[j-1];
+			segDd[j] = (double) distTable[j] - (double) distTable[j-1];
+			segDp[j] = (double) proxTable[j] - (double) proxTable[j-1];
+		}
+	}
+	
+	for (k = 0; k + 2 <= n; k += 2)
+	{
+		//	First entry with psVal >= proxTable[i], i.e. not proxTable[i] > psVal, two chunks at a time
+		for (j = 0; j < 2; j++)
+		{
+			__m128i value = _mm_xor_si128(_mm_set1_epi16((short) psVals[k + j]), bias);
+			uint16_t idx = tableLen;
+			
+			for (c = 0; c < chunkCount; c += 2)
+			{
+				match = ~_mm_movemask_epi8(_mm_cmpgt_epi16(chunks[c], value)) & laneMask[c];
+				match |= (~_mm_movemask_epi8(_mm_cmpgt_epi16(chunks[c + 1], value)) & laneMask[c + 1]) << 16;
+				if (match)
+				{
+					idx = c * 8 + __builtin_ctz(match) / 2;
+					break;
+				}
+			}
+			
+			if (j == 0) i0 = idx;
+			else i1 = idx;
+		}
+		
+		//	Same operations in the same order as Distance_Lookup(), two values at a time
+		x = _mm_set_pd((double) psVals[k + 1], (double) psVals[k]);
+		vd = _mm_mul_pd(_mm_sub_pd(x, _mm_set_pd(segP0[i1], segP0[i0])), _mm_set_pd(segDd[i1], segDd[i0]));
+		vd = _mm_div_pd(vd, _mm_set_pd(segDp[i1], segDp[i0]));
+		_mm_storeu_pd(&distances[k], _mm_add_pd(_mm_set_pd(segA[i1], segA[i0]), vd));
+	}
+#else
+	k = 0;
+#endif
+
+	//	Scalar fallback and remainder
+	for (; k < n; k++)
+	{
+		distances[k] = Distance_Lookup(psVals[k], proxTable, distTable, tableLen);
+	}
+}
+
+/**
+ * @brief Acceleration variance per sample of a distance Kalman filter, from its deviation and period
+ * 
+ * @param [out] kalman
+ */
+static void Kalman_Noise(SensorKalman* kalman)
+{
+	double accel = kalman->accel * (kalman->period * 1e-6) * (kalman->period * 1e-6);
+	double q = accel * accel * (1L << SENSOR_KALMAN_COV_BITS);
+	
+	kalman->q = (q > KALMAN_COV_MAX) ? KALMAN_COV_MAX : (int32_t) (q + 0.5);
+}
+
+void Init_Sensor_Kalman(SensorKalman* kalman, uint16_t psNoise, uint16_t accel, uint32_t period)
+{
+	kalman->psNoise = psNoise;
+	kalman->accel = accel;
+	kalman->period = period ? period : 1;
+	kalman->distance = 0;
+	kalman->velocity = 0;
+	kalman->p00 = 0;
+	kalman->p01 = 0;
+	kalman->p11 = 0;
+	kalman->started = 0;
+	Kalman_Noise(kalman);
+}
+
+void Set_Kalman_Period(SensorKalman* kalman, uint32_t period)
+{
+	uint32_t previous = kalman->period;
+	
+	if (period == 0) period = 1;
+	if (period == previous) return;
+	
+	//	Velocity per sample scales with the period, its variance with the square
+	kalman->period = period;
+	kalman->velocity = (int32_t) ((int64_t) kalman->velocity * period / previous);
+	kalman->p01 = Kalman_Clamp((int64_t) kalman->p01 * period / previous);
+	kalman->p11 = Kalman_Clamp((int64_t) kalman->p11 * period / previous * period / previous);
+	Kalman_Noise(kalman);
+}
+
+void Init_Sensor_Baseline(SensorBaseline* baseline, uint16_t reference, uint16_t decimation)
+{
+	memset(baseline->blockMin, 0, sizeof(baseline->blockMin));
+	baseline->currentMin = UINT16_MAX;
+	baseline->decimation = decimation ? decimation : 1;
+	baseline->blockFill = 0;
+	baseline->head = 0;
+	baseline->fill = 0;
+	baseline->reference = reference;
+	baseline->baseline = reference;
+}
+
+void Init_Sensor_Sketch(SensorSketch* sketch)
+{
+	memset(sketch->count, 0, sizeof(sketch->count));
+	sketch->total = 0;
+	sketch->halvings = 0;
+}
+
+/**
+ * @brief Halve every count of a sketch
+ * 
+ * @param [out] sketch
+ */
+static void Sketch_Halve(SensorSketch* sketch)
+{
+	uint16_t i;
+	
+	for (i = 0; i < SENSOR_SKETCH_LEN; i++) sketch->count[i] >>= 1;
+	sketch->halvings++;
+}
+
+/**
+ * @brief Sketch bucket of a value: the value itself below 2^(SUB_BITS + 1), else octave and mantissa
+ * 
+ * @param [in] value
+ * @return bucket index
+ */
+static uint16_t Sketch_Bucket(uint16_t value)
+{
+	uint8_t shift = 0;
+	
+	//	Mantissa in [2^SUB_BITS, 2^(SUB_BITS + 1)) after the shift, one octave of buckets per shift
+	while ((value >> shift) >= (2 << SENSOR_SKETCH_SUB_BITS)) shift++;
+	if (shift == 0) return value;
+	
+	return ((uint16_t) shift << SENSOR_SKETCH_SUB_BITS) + (value >> shift);
+}
+
+void Sensor_Sketch_Add(SensorSketch* sketch, uint16_t value)
+{
+	uint16_t bucket = Sketch_Bucket(value);
+	
+	if (sketch->count[bucket] == UINT16_MAX) Sketch_Halve(sketch);
+	sketch->count[bucket]++;
+	sketch->total++;
+}
+
+void Sensor_Sketch_Merge(SensorSketch* sketch, const SensorSketch* other)
+{
+	uint16_t i;
+	uint8_t shift;
+	uint32_t count;
+	
+	while (sketch->halvings < other->halvings) Sketch_Halve(sketch);
+	shift = sketch->halvings - other->halvings;
+	
+	for (i = 0; i < SENSOR_SKETCH_LEN; i++)
+	{
+		count = (uint32_t) sketch->count[i] + (shift < 16 ? (other->count[i] >> shift) : 0);
+		if (count > UINT16_MAX)
+		{
+			//	Halve the counts merged so far and the current sum, then go on at the new scale
+			Sketch_Halve(sketch);
+			count >>= 1;
+			shift++;
+		}
+		sketch->count[i] = (uint16_t) count;
+	}
+	
+	sketch->total += other->total;
+}
+
+double Sensor_Sketch_Quantile(const SensorSketch* sketch, double q)
+{
+	uint32_t sum = 0, below = 0;
+	uint16_t i, shift;
+	double rank;
+	
+	for (i = 0; i < SENSOR_SKETCH_LEN; i++) sum += sketch->count[i];
+	if (sum == 0) return 0;
+	
+	if (q < 0) q = 0;
+	if (q > 1) q = 1;
+	rank = q * sum;
+	
+	for (i = 0; i < SENSOR_SKETCH_LEN; i++)
+	{
+		if ((sketch->count[i] > 0) && (below + sketch->count[i] >= rank)) break;
+		below += sketch->count[i];
+	}
+	
+	//	Bucket i covers [m << shift, (m + 1) << shift) for its mantissa m, interpolate by rank within it
+	if (i < (2U << SENSOR_SKETCH_SUB_BITS))
+		return i + (rank - below) / sketch->count[i];
+	
+	shift = (i >> SENSOR_SKETCH_SUB_BITS) - 1;
+	return ((double) (i - (shift << SENSOR_SKETCH_SUB_BITS)) + (rank - below) / sketch->count[i]) * (1UL << shift);
+}
+
+void Init_Distance_Model(SensorModel* model, double a, double b, double c)
+{
+	double scale = (a > 0) ? sqrt(a) * 16 : 0;
+	double bias = floor(b * 256 + 0.5);
+	
+	model->scale = (scale > SENSOR_MODEL_SCALE_MAX) ? SENSOR_MODEL_SCALE_MAX : (uint32_t) (scale + 0.5);
+	model->bias = (bias < INT16_MIN) ? INT16_MIN : (bias > INT16_MAX) ? INT16_MAX : (int16_t) bias;
+	model->offset = (c < 0) ? 0 : (c > UINT16_MAX) ? UINT16_MAX : (uint16_t) (c + 0.5);
+}
+
+/**
+ * @brief Reciprocal square root of a normalised value
+ * 
+ * @param [in] m value in [2^14, 2^16), i.e. [0.25, 1) with 16 fractional bits
+ * @return 1 / sqrt(m) with 14 fractional bits
+ */
+static uint16_t RSqrt_Q14(uint16_t m)
+{
+	uint32_t y = rsqrtSeed[(m >> 10) - 16];
+	uint32_t t;
+	
+	//	One Newton step y (3 - m y^2) / 2, the seed is within 1.6 %
+	t = ((uint32_t) m * y) >> 16;
+	t = (t * y) >> 14;
+	return (uint16_t) ((y * ((3UL << 14) - t)) >> 15);
+}
+
+double Distance_Model(uint16_t psVal, const SensorModel* model)
+{
+	const int32_t nearest = (int32_t) distanceTable[0] << 8;
+	const int32_t farthest = (int32_t) distanceTable[DIST_LOOKUP_LEN - 1] << 8;
+	uint16_t m;
+	uint8_t shift = 0;
+	int32_t distance;
+	
+	//	No hand signal above the offset
+	if (psVal <= model->offset) return (double) distanceTable[DIST_LOOKUP_LEN - 1];
+	
+	//	Normalise by an even shift, 1 / sqrt(PS - c) = 1 / sqrt(m) * 2^(shift - 8)
+	m = psVal - model->offset;
+	while (m < 0x4000)
+	{
+		m <<= 2;
+		shift++;
+	}
+	
+	//	sqrt(a) / sqrt(PS - c) - b, in 1/256 cm
+	distance = (int32_t) ((model->scale * RSqrt_Q14(m)) >> (18 - shift)) - model->bias;
+	
+	if (distance < nearest) distance = nearest;
+	if (distance > farthest) distance = farthest;
+	
+	return (double) distance / 256;
+}
+
 #ifdef __cplusplus
 }
 #endif
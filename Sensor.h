@@ -28,15 +28,277 @@ extern "C" {
 /** @brief Length of the sensor value history */
 #define SENSOR_HIST_LEN 50
 
-/** @brief Length of proximity window */
+/** @brief Default length of proximity window, see Set_PS_Window() */
 #define PS_WINDOW 25
 
-/** @brief Length of ALS window */
-#define ALS_WINDOW 25
+/** @brief Default length of the fast proximity window, see Set_PS_Fast_Window() */
+#define PS_FAST_WINDOW 4
+
+/** @brief Length of ALS window, 250 ms at the 50 ms ALS integration time the sketch samples ALS at */
+#ifndef ALS_WINDOW
+#define ALS_WINDOW 5
+#endif
 
 /** @brief Length of #distanceTable array */
 #define DIST_LOOKUP_LEN 16
 
+/** @brief Fractional bits of the SensorKalman distance and velocity */
+#define SENSOR_KALMAN_STATE_BITS 16
+
+/** @brief Fractional bits of the SensorKalman covariances, gains and noise variances */
+#define SENSOR_KALMAN_COV_BITS 24
+
+/** @brief Initial velocity standard deviation of a SensorKalman (in cm/s) */
+#ifndef SENSOR_KALMAN_SPEED
+#define SENSOR_KALMAN_SPEED 100
+#endif
+
+/** @brief Number of decimated blocks in a SensorBaseline, its horizon in blocks */
+#ifndef SENSOR_BASELINE_LEN
+#define SENSOR_BASELINE_LEN 16
+#endif
+
+/** @brief Rank of the SensorBaseline among its block minima, from 0 for the lowest, above IR noise burst blocks */
+#ifndef SENSOR_BASELINE_RANK
+#define SENSOR_BASELINE_RANK 6
+#endif
+
+/** @brief Smallest change of \ref Sensor.psOffset (in counts), so block noise does not restart the window */
+#ifndef SENSOR_BASELINE_DEADBAND
+#define SENSOR_BASELINE_DEADBAND 4
+#endif
+
+/** @brief Sub-buckets per octave of a SensorSketch, as a power of 2 */
+#ifndef SENSOR_SKETCH_SUB_BITS
+#define SENSOR_SKETCH_SUB_BITS 3
+#endif
+
+/** @brief Number of SensorSketch buckets: values below 2^(SUB_BITS + 1) exact, then each octave to 2^16 */
+#define SENSOR_SKETCH_LEN ((17 - SENSOR_SKETCH_SUB_BITS) << SENSOR_SKETCH_SUB_BITS)
+
+/*
+ * Define SENSOR_COMPRESSED_HIST to store the PS history as 8-bit deltas from the previous sample instead of
+ * full 16-bit values, and to keep only the ALS_WINDOW samples the ALS window reads. Deltas outside
+ * [-128, 127] keep their high byte in a small escape ring, freed once the sample leaves the longest PS
+ * window, so with windows up to SENSOR_HIST_ESC_LEN samples the ring cannot overflow and the history is
+ * exact. A longer window that does overflow it restarts the windows on the new sample, see
+ * \ref SensorHist.rebaseCount. History RAM goes from 200 to 101 bytes.
+ */
+#ifdef SENSOR_COMPRESSED_HIST
+
+/** @brief Length of the escape ring of a compressed history, the longest PS window it holds exactly */
+#ifndef SENSOR_HIST_ESC_LEN
+#define SENSOR_HIST_ESC_LEN PS_WINDOW
+#endif
+
+/** @brief Length of the ALS history, the ALS window only */
+#define ALS_HIST_LEN ALS_WINDOW
+
+/**
+ * @struct SensorHist_t
+ * @brief Compressed value history with a cursor on the oldest sample of its window
+ */
+typedef struct __attribute__ ((__packed__)) SensorHist_t
+{
+	/** @brief Low byte of the delta from the previous sample modulo 2^16, the whole delta unless escaped */
+	int8_t delta[SENSOR_HIST_LEN];
+	
+	/** @brief Bit per sample, set if the delta's high byte is in \ref SensorHist.escape */
+	uint8_t escaped[(SENSOR_HIST_LEN + 7) / 8];
+	
+	/** @brief High bytes of escaped deltas, in recording order */
+	uint8_t escape[SENSOR_HIST_ESC_LEN];
+	
+	/** @brief Escape slot used by the next escaped delta */
+	uint8_t escHead;
+	
+	/** @brief Number of escaped deltas still within the longest window */
+	uint8_t escCount;
+	
+	/** @brief Newest value */
+	uint16_t newest;
+	
+	/** @brief Value of the oldest sample in the window */
+	uint16_t tailValue;
+	
+	/** @brief Escape slot of the next escaped delta after the window's oldest sample */
+	uint8_t tailEsc;
+	
+	/** @brief Number of window restarts because the escape ring was full */
+	uint16_t rebaseCount;
+} SensorHist;
+
+#else
+
+/** @brief Length of the ALS history */
+#define ALS_HIST_LEN SENSOR_HIST_LEN
+
+#endif /* SENSOR_COMPRESSED_HIST */
+
+/*
+ * Define SENSOR_MINMAX_DEQUE for large PS windows, to keep the window minimum and maximum with monotonic deques
+ * on every sample, batch included, instead of taking them in the STD pass. That pass already reads the whole
+ * window, and on the host it is cheaper than the deques up to a window of about 25 samples. The deques index
+ * the history, so they need the plain one.
+ */
+#ifdef SENSOR_MINMAX_DEQUE
+
+#ifdef SENSOR_COMPRESSED_HIST
+#error "SENSOR_MINMAX_DEQUE needs random access to the history, not SENSOR_COMPRESSED_HIST"
+#endif
+
+/**
+ * @struct SensorDeque_t
+ * @brief Monotonic deque of history slots for a sliding window minimum or maximum
+ * 
+ * Holds the window samples that may still become its minimum (maximum): each is below (above) every older
+ * one held, so the oldest held is the window's extreme. A sample is pushed and popped at most once, O(1)
+ * amortised per sample.
+ */
+typedef struct __attribute__ ((__packed__)) SensorDeque_t
+{
+	/** @brief History slots, oldest first from \ref SensorDeque.head, a ring buffer */
+	uint8_t slot[SENSOR_HIST_LEN];
+	
+	/** @brief Ring index of the oldest held sample */
+	uint8_t head;
+	
+	/** @brief Number of held samples */
+	uint8_t count;
+} SensorDeque;
+
+#endif /* SENSOR_MINMAX_DEQUE */
+
+/**
+ * @enum SensorFilter_t
+ * @brief PS value the proximity hysteresis is run on
+ */
+typedef enum SensorFilter_t
+{
+	/** @brief Raw PS value, reacts within one sample */
+	SENSOR_FILTER_RAW,
+	
+	/** @brief PS window mean, as \ref Sensor.psMean, rejects spikes shorter than half the window */
+	SENSOR_FILTER_MEAN,
+	
+	/** @brief Fast window mean of \ref Sensor.psFastWindow samples, enters within a few samples */
+	SENSOR_FILTER_FAST
+} SensorFilter;
+
+/**
+ * @struct SensorModel_t
+ * @brief Inverse-square distance model PS = a / (d + b)^2 + c in fixed point, see Init_Distance_Model()
+ */
+typedef struct SensorModel_t
+{
+	/** @brief sqrt(a), 4 fractional bits, at most #SENSOR_MODEL_SCALE_MAX */
+	uint32_t scale;
+	
+	/** @brief b (in 1/256 cm) */
+	int16_t bias;
+	
+	/** @brief c (in counts) */
+	uint16_t offset;
+} SensorModel;
+
+/**
+ * @struct SensorKalman_t
+ * @brief Constant velocity Kalman filter of the distance of raw PS samples, in fixed point
+ * 
+ * Velocity is counted per sample, so a step is free of the sample period; Set_Kalman_Period() rescales it
+ * when the period changes.
+ */
+typedef struct SensorKalman_t
+{
+	/** @brief Filtered distance (in cm), #SENSOR_KALMAN_STATE_BITS fractional bits */
+	int32_t distance;
+	
+	/** @brief Velocity (in cm per sample), #SENSOR_KALMAN_STATE_BITS fractional bits */
+	int32_t velocity;
+	
+	/** @brief Distance variance, #SENSOR_KALMAN_COV_BITS fractional bits */
+	int32_t p00;
+	
+	/** @brief Distance and velocity covariance, #SENSOR_KALMAN_COV_BITS fractional bits */
+	int32_t p01;
+	
+	/** @brief Velocity variance, #SENSOR_KALMAN_COV_BITS fractional bits */
+	int32_t p11;
+	
+	/** @brief Acceleration variance per sample, #SENSOR_KALMAN_COV_BITS fractional bits */
+	int32_t q;
+	
+	/** @brief PS noise standard deviation (in counts) */
+	uint16_t psNoise;
+	
+	/** @brief Acceleration standard deviation of the hand (in cm/s^2) */
+	uint16_t accel;
+	
+	/** @brief Sample period (in us) */
+	uint32_t period;
+	
+	/** @brief Set by the first sample after a reset */
+	uint8_t started;
+} SensorKalman;
+
+/**
+ * @struct SensorBaseline_t
+ * @brief Low percentile tracker of the PS baseline over a long decimated history, see Set_PS_Baseline()
+ * 
+ * Every sample only updates the minimum of the current block of \ref SensorBaseline.decimation samples.
+ * The baseline is the #SENSOR_BASELINE_RANK lowest of the last #SENSOR_BASELINE_LEN block minima, so a
+ * hand raises it only when held for most of the horizon.
+ */
+typedef struct SensorBaseline_t
+{
+	/** @brief Minima of the latest completed blocks, a ring buffer */
+	uint16_t blockMin[SENSOR_BASELINE_LEN];
+	
+	/** @brief Minimum of the current block */
+	uint16_t currentMin;
+	
+	/** @brief Samples per block */
+	uint16_t decimation;
+	
+	/** @brief Samples in the current block */
+	uint16_t blockFill;
+	
+	/** @brief Slot of the next completed block */
+	uint8_t head;
+	
+	/** @brief Number of completed blocks, saturates at #SENSOR_BASELINE_LEN */
+	uint8_t fill;
+	
+	/** @brief Baseline the thresholds and proximity table are tuned for, 0 until taken from the first block */
+	uint16_t reference;
+	
+	/** @brief Tracked baseline (in counts), \ref SensorBaseline.reference until the first block completes */
+	uint16_t baseline;
+} SensorBaseline;
+
+/**
+ * @struct SensorSketch_t
+ * @brief Log-bucketed histogram of 16-bit values for long horizon quantiles, see Set_Sensor_Sketch()
+ * 
+ * Buckets split each octave in 2^#SENSOR_SKETCH_SUB_BITS, a relative width of at most 1/8 by default,
+ * so a value is counted with a few shifts. When a count saturates every count is halved, so older samples
+ * weigh progressively less. Sketches of the same layout merge by adding counts.
+ */
+typedef struct SensorSketch_t
+{
+	/** @brief Samples per bucket, times 2^-\ref SensorSketch.halvings */
+	uint16_t count[SENSOR_SKETCH_LEN];
+	
+	/** @brief Samples added, including merged ones */
+	uint32_t total;
+	
+	/** @brief Number of times the counts were halved */
+	uint8_t halvings;
+} SensorSketch;
+
+/** @brief Largest \ref SensorModel.scale, so its product with a reciprocal square root fits 32 bits */
+#define SENSOR_MODEL_SCALE_MAX 131071UL
+
 /**
  * @brief Distance reference values for distance lookup via proximity counts
  */
@@ -51,17 +313,43 @@ typedef struct __attribute__ ((__packed__)) Sensor_t
 	/** @brief Index value of sensor for identifying position */
 	uint8_t index;
 	
-	/** @brief Number of samples collected by sensor */
+	/** @brief Number of PS samples collected by sensor */
 	uint32_t sampleCount;
 	
+	/** @brief Number of ALS samples collected by sensor */
+	uint32_t alsSampleCount;
+	
 	/** @brief Proximity lookup table with respect to #distanceTable */
 	uint16_t* proxTable;
 	
+	/** @brief Distance model used instead of \ref Sensor.proxTable, NULL for the table */
+	const SensorModel* distanceModel;
+	
+	/** @brief Distance filter of raw PS samples used instead of the PS window mean, NULL for the mean */
+	SensorKalman* kalman;
+	
+	/** @brief PS baseline tracker offsetting the thresholds and distance lookup, NULL for fixed ones */
+	SensorBaseline* baseline;
+	
+	/** @brief PS counts subtracted before the hysteresis and distance lookup, from \ref Sensor.baseline */
+	int16_t psOffset;
+	
+	/** @brief Long horizon distribution of PS samples, NULL for none, kept across Reset_Sensor() */
+	SensorSketch* psSketch;
+	
+	/** @brief Long horizon distribution of ALS samples, NULL for none, kept across Reset_Sensor() */
+	SensorSketch* alsSketch;
+	
+#ifdef SENSOR_COMPRESSED_HIST
+	/** @brief Compressed proximity history for mean, STD calculation */
+	SensorHist psHist;
+#else
 	/** @brief Proximity history for mean, STD calculation */
 	uint16_t psHist[SENSOR_HIST_LEN];
+#endif
 	
 	/** @brief ALS history for mean, STD calculation */
-	uint16_t alsHist[SENSOR_HIST_LEN];
+	uint16_t alsHist[ALS_HIST_LEN];
 	
 	/** @brief PS mean value calculated from historical window */
 	uint16_t psMean;
@@ -75,26 +363,87 @@ typedef struct __attribute__ ((__packed__)) Sensor_t
 	/** @brief ALS STD value calculated from historical window */
 	double alsSTD;
 	
-	/** @brief Estimated distance looked up from mean proximity */
+	/** @brief Minimum of the PS window */
+	uint16_t psMin;
+	
+	/** @brief Maximum of the PS window */
+	uint16_t psMax;
+	
+	/** @brief Minimum of the ALS window */
+	uint16_t alsMin;
+	
+	/** @brief Maximum of the ALS window, 0 when the sensor is covered */
+	uint16_t alsMax;
+	
+#ifdef SENSOR_MINMAX_DEQUE
+	/** @brief Monotonic deques behind \ref Sensor.psMin, \ref Sensor.psMax */
+	SensorDeque psMinDeque, psMaxDeque;
+	
+	/** @brief Monotonic deques behind \ref Sensor.alsMin, \ref Sensor.alsMax */
+	SensorDeque alsMinDeque, alsMaxDeque;
+#endif
+	
+	/** @brief Estimated distance looked up from mean proximity, or filtered by \ref Sensor.kalman */
 	double estimatedDistance;
 	
+	/** @brief Estimated velocity away from the sensor (in cm/s) from \ref Sensor.kalman, 0 without */
+	double estimatedVelocity;
+	
+	/** @brief Least squares slope of the PS window sample distances (in cm per sample) */
+	double distanceSlope;
+	
+	/** @brief Least squares distance at the newest PS window sample, free of the window mean's group delay */
+	double predictedDistance;
+	
 	/** @brief Hysteresis exit threshold for #Sensor.inProximity */
 	uint16_t psProxMin;
 	
 	/** @brief Hysteresis enter threshold for \ref Sensor.inProximity */
 	uint16_t psProxMax;
 	
+	/** @brief PS value the hysteresis is run on, see #SensorFilter */
+	uint8_t psFilter;
+	
+	/** @brief Length of proximity window, at most #SENSOR_HIST_LEN */
+	uint8_t psWindow;
+	
+	/** @brief Length of the fast proximity window within the same history, at most #SENSOR_HIST_LEN */
+	uint8_t psFastWindow;
+	
 	/** @brief Flag for target detected within sensor proximity */
 	uint8_t inProximity;
 	
 	/** @brief Flag for target detected obstructing sensor */
 	uint8_t isBlocked;
 	
-	/** @brief Sum of PS_WINDOW elements within \ref Sensor.psHist */
+	/** @brief Sum of \ref Sensor.psWindow latest elements within \ref Sensor.psHist */
 	uint32_t psWindowSum;
 	
 	/** @brief Sum of ALS_WINDOW latest elements within \ref Sensor.alsHist */
 	uint32_t alsWindowSum;
+	
+	/** @brief Sum of \ref Sensor.psFastWindow latest elements within \ref Sensor.psHist */
+	uint32_t psFastSum;
+	
+#ifdef SENSOR_COMPRESSED_HIST
+	/** @brief Value of the oldest sample in the fast window */
+	uint16_t psFastValue;
+	
+	/** @brief Escape slot of the next escaped delta after the fast window's oldest sample */
+	uint8_t psFastEsc;
+#endif
+	
+	/** @brief Sum of the distances of the PS window samples (in 1/256 cm) */
+	int32_t distWindowSum;
+	
+	/** @brief Sum of the distances of the PS window samples times their place after the oldest (in 1/256 cm) */
+	int32_t distWindowMoment;
+	
+	/** @brief Number of PS samples in the window since the last restart, saturates at #SENSOR_HIST_LEN */
+	uint8_t psWindowFill;
+	
+	/** @brief Number of ALS samples in the window since the last reset, saturates at #SENSOR_HIST_LEN */
+	uint8_t alsWindowFill;
 } Sensor;
 
 /**
@@ -115,15 +464,144 @@ void Init_Sensor(Sensor* sensor, uint8_t index, uint16_t psProxMin, uint16_t psP
  */
 void Reset_Sensor(Sensor* sensor);
 
+/**
+ * @brief Restart PS window from the next sample, keeping proximity state
+ * 
+ * Windows are counted in samples, so this is used when the PS sampling period changes to keep every
+ * window made of evenly spaced samples.
+ * 
+ * @param [out] sensor
+ */
+void Restart_Window(Sensor* sensor);
+
+/**
+ * @brief Change the proximity window length, restarting the window
+ * 
+ * @param [out] sensor
+ * @param [in] window length, clamped to [1, #SENSOR_HIST_LEN]
+ */
+void Set_PS_Window(Sensor* sensor, uint8_t window);
+
+/**
+ * @brief Change the fast proximity window length, restarting the windows
+ * 
+ * The fast window is the latest samples of the PS history, for the #SENSOR_FILTER_FAST hysteresis, while
+ * the PS window keeps the distance estimate smooth.
+ * 
+ * @param [out] sensor
+ * @param [in] window length, clamped to [1, #SENSOR_HIST_LEN]
+ */
+void Set_PS_Fast_Window(Sensor* sensor, uint8_t window);
+
+/**
+ * @brief Estimate distance with an inverse-square model instead of the proximity table
+ * 
+ * Restarts the PS window, whose distance sums are of the previous conversion. The table stays the default,
+ * as it fits the curve more closely; the model holds a unit's calibration in three parameters.
+ * 
+ * @param [out] sensor
+ * @param [in] model must outlive the sensor, NULL restores the proximity table
+ */
+void Set_Distance_Model(Sensor* sensor, const SensorModel* model);
+
+/**
+ * @brief Estimate distance with a Kalman filter of raw PS samples instead of the PS window mean
+ * 
+ * The filter restarts from the next sample. Each raw sample is converted by the distance model or the
+ * proximity table, with a variance from the distance change of one PS noise deviation, so flat regions
+ * of the curve weigh less. Lag is a few samples instead of half the window.
+ * 
+ * @param [out] sensor
+ * @param [in] kalman must outlive the sensor, NULL restores the PS window mean
+ */
+void Set_Distance_Kalman(Sensor* sensor, SensorKalman* kalman);
+
+/**
+ * @brief Track the PS baseline and offset the hysteresis thresholds and proximity table by its drift
+ * 
+ * Crosstalk from the cover glass and the sunlight cancellation residue drift with temperature and dust.
+ * \ref Sensor.psOffset follows the baseline's drift from its reference, in steps of at least
+ * #SENSOR_BASELINE_DEADBAND counts, and is subtracted from PS values before the hysteresis and distance
+ * lookup. Each step restarts the PS window, whose distance sums are of the previous offset.
+ * 
+ * @param [out] sensor
+ * @param [in] baseline must outlive the sensor, NULL restores fixed thresholds
+ */
+void Set_PS_Baseline(Sensor* sensor, SensorBaseline* baseline);
+
+/**
+ * @brief Count every PS, ALS sample into long horizon quantile sketches
+ * 
+ * @param [out] sensor
+ * @param [in] psSketch must outlive the sensor, NULL for none
+ * @param [in] alsSketch must outlive the sensor, NULL for none
+ */
+void Set_Sensor_Sketch(Sensor* sensor, SensorSketch* psSketch, SensorSketch* alsSketch);
+
 /**
  * @brief Update sensor with latest proximity, ALS value
  * 
+ * Equivalent to Update_Sensor_ALS() followed by Update_Sensor_PS(), for callers sampling both channels
+ * at the same rate.
+ * 
  * @param [out] sensor
  * @param [in] psVal
  * @param [in] alsVal
  */
 void Update_Sensor(Sensor* sensor, uint16_t psVal, uint16_t alsVal);
 
+/**
+ * @brief Update sensor with a batch of proximity, ALS values, oldest first
+ *
+ * Updates the window sums and histories for every sample, and the derived means, STD and estimated distance
+ * once from the last sample, leaving them as n calls to Update_Sensor() would. The proximity hysteresis and
+ * blocked flag are still run on every PS value, so transitions within the batch are counted and an exit
+ * clears the blocked flag. As the ALS samples go first, the blocked flag sees the ALS window of the batch's
+ * last sample. Either array may be NULL to update a single channel, e.g. for split PS, ALS cadences.
+ *
+ * @param [out] sensor
+ * @param [in] ps n proximity values, or NULL
+ * @param [in] als n ALS values, or NULL
+ * @param [in] n
+ * @return number of times proximity was entered within the batch
+ */
+uint16_t Update_Sensor_Batch(Sensor* sensor, const uint16_t* ps, const uint16_t* als, uint16_t n);
+
+/**
+ * @brief Update sensor with latest proximity value
+ * 
+ * Updates PS window, mean, STD, minimum, maximum, estimated and predicted distance and the proximity, blocked
+ * flags.
+ * 
+ * @param [out] sensor
+ * @param [in] psVal
+ */
+void Update_Sensor_PS(Sensor* sensor, uint16_t psVal);
+
+/**
+ * @brief Update sensor with a proximity value, leaving the derived fields to a later Update_Sensor_PS()
+ * 
+ * Updates the PS window sums and history, baseline and Kalman filter, and runs the proximity hysteresis and
+ * blocked flag on the value, as Update_Sensor_Batch() does for all but its last sample. The means, STD,
+ * minimum, maximum and distances keep their values from the last Update_Sensor_PS().
+ * 
+ * @param [out] sensor
+ * @param [in] psVal
+ * @return 1 if entering into proximity, 0 otherwise
+ */
+uint8_t Update_Sensor_PS_Sample(Sensor* sensor, uint16_t psVal);
+
+/**
+ * @brief Update sensor with latest ALS value
+ * 
+ * Updates ALS window, mean, STD, minimum, maximum and the blocked flag. Should be called once per ALS
+ * conversion, so repeated reads of the same conversion do not bias the ALS statistics.
+ * 
+ * @param [out] sensor
+ * @param [in] alsVal
+ */
+void Update_Sensor_ALS(Sensor* sensor, uint16_t alsVal);
+
 /**
  * @brief Distance lookup for proximity counts based on linear interpolation
  * 
@@ -135,6 +613,106 @@ void Update_Sensor(Sensor* sensor, uint16_t psVal, uint16_t alsVal);
  */
 double Distance_Lookup(uint16_t psVal, uint16_t* proxTable, uint16_t* distTable, uint8_t tableLen);
 
+/**
+ * @brief Distance lookup for an array of proximity counts, bit-exact with Distance_Lookup()
+ * 
+ * Intended for offline analysis of long traces. With SSE2 the table search is a branchless compare of
+ * eight entries at a time, and the interpolation is done two values at a time; otherwise every value is
+ * looked up in turn.
+ * 
+ * @param [in] psVals
+ * @param [out] distances estimatedDistance for every value (in cm)
+ * @param [in] n
+ * @param [in] proxTable
+ * @param [in] distTable
+ * @param [in] tableLen
+ */
+void Distance_Lookup_Batch(const uint16_t* psVals, double* distances, uint32_t n, uint16_t* proxTable, uint16_t* distTable, uint8_t tableLen);
+
+/**
+ * @brief Initialise a distance Kalman filter
+ * 
+ * @param [out] kalman
+ * @param [in] psNoise PS noise standard deviation (in counts)
+ * @param [in] accel acceleration standard deviation of the hand (in cm/s^2), higher follows faster
+ * @param [in] period sample period (in us)
+ */
+void Init_Sensor_Kalman(SensorKalman* kalman, uint16_t psNoise, uint16_t accel, uint32_t period);
+
+/**
+ * @brief Change the sample period of a distance Kalman filter, keeping its state
+ * 
+ * @param [out] kalman
+ * @param [in] period (in us)
+ */
+void Set_Kalman_Period(SensorKalman* kalman, uint32_t period);
+
+/**
+ * @brief Initialise a PS baseline tracker
+ * 
+ * @param [out] baseline
+ * @param [in] reference baseline the thresholds are tuned for (in counts), 0 to take it from the first block
+ * @param [in] decimation samples per block, the horizon is #SENSOR_BASELINE_LEN times as long
+ */
+void Init_Sensor_Baseline(SensorBaseline* baseline, uint16_t reference, uint16_t decimation);
+
+/**
+ * @brief Initialise an empty quantile sketch
+ * 
+ * @param [out] sketch
+ */
+void Init_Sensor_Sketch(SensorSketch* sketch);
+
+/**
+ * @brief Count a value into a quantile sketch, O(1) amortised
+ * 
+ * @param [out] sketch
+ * @param [in] value
+ */
+void Sensor_Sketch_Add(SensorSketch* sketch, uint16_t value);
+
+/**
+ * @brief Add the counts of one sketch to another, e.g. of other units or time ranges
+ * 
+ * The sketch halved fewer times is halved to match the other first.
+ * 
+ * @param [out] sketch
+ * @param [in] other
+ */
+void Sensor_Sketch_Merge(SensorSketch* sketch, const SensorSketch* other);
+
+/**
+ * @brief Quantile of the counted values, interpolated within its bucket
+ * 
+ * @param [in] sketch
+ * @param [in] q quantile in [0, 1]
+ * @return value at quantile q, 0 if the sketch is empty
+ */
+double Sensor_Sketch_Quantile(const SensorSketch* sketch, double q);
+
+/**
+ * @brief Fixed point form of the distance model PS = a / (d + b)^2 + c, e.g. as fitted by host/calibrate
+ * 
+ * @param [out] model
+ * @param [in] a clamped so sqrt(a) is at most #SENSOR_MODEL_SCALE_MAX / 16
+ * @param [in] b (in cm)
+ * @param [in] c (in counts)
+ */
+void Init_Distance_Model(SensorModel* model, double a, double b, double c);
+
+/**
+ * @brief Distance of proximity counts from an inverse-square model
+ * 
+ * d = sqrt(a) / sqrt(PS - c) - b, with a fixed point reciprocal square root: a seed table and one Newton
+ * step, within 0.05 % of the exact value. Needs neither a table search nor a division, and no floating
+ * point up to the returned value.
+ * 
+ * @param [in] psVal
+ * @param [in] model
+ * @return estimatedDistance (in cm), within the range of #distanceTable
+ */
+double Distance_Model(uint16_t psVal, const SensorModel* model);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,89 @@
+/**
+ * @file Snapshot.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the published Sensor output snapshot, and related variables, methods
+ *
+ * The SnapshotCell object publishes a consistent copy of the derived Sensor outputs with a sequence lock.
+ * The single writer (sampling task, ISR or I2C completion) makes the sequence odd while it copies and even
+ * when done; readers copy without blocking the writer and retry if the sequence was odd or changed. No
+ * interrupts are disabled, and any number of readers may read concurrently.
+ */
+
+
+#include "Snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Init_Snapshot(SnapshotCell* cell)
+{
+	cell->seq = 0;
+	memset(&cell->data, 0, sizeof(SensorSnapshot));
+}
+
+void Snapshot_Publish(SnapshotCell* cell, const Sensor* sensor, uint16_t psVal, uint16_t alsVal, uint32_t toggleCount)
+{
+	volatile SensorSnapshot* data = &cell->data;
+
+	cell->seq++;
+	SNAPSHOT_FENCE();
+
+	data->sampleCount = sensor->sampleCount;
+	data->psMean = sensor->psMean;
+	data->alsMean = sensor->alsMean;
+	data->psSTD = sensor->psSTD;
+	data->alsSTD = sensor->alsSTD;
+	data->estimatedDistance = sensor->estimatedDistance;
+	data->estimatedVelocity = sensor->estimatedVelocity;
+	data->psOffset = sensor->psOffset;
+	data->psVal = psVal;
+	data->alsVal = alsVal;
+	data->toggleCount = toggleCount;
+	data->inProximity = sensor->inProximity;
+	data->isBlocked = sensor->isBlocked;
+
+	SNAPSHOT_FENCE();
+	cell->seq++;
+}
+
+uint8_t Snapshot_Read(const SnapshotCell* cell, SensorSnapshot* snapshot)
+{
+	SnapshotSeq begin, end;
+	uint8_t retries = 0;
+	const volatile SensorSnapshot* data = &cell->data;
+
+	for (;;)
+	{
+		begin = cell->seq;
+		SNAPSHOT_FENCE();
+
+		if ((begin & 1) == 0)
+		{
+			snapshot->sampleCount = data->sampleCount;
+			snapshot->psMean = data->psMean;
+			snapshot->alsMean = data->alsMean;
+			snapshot->psSTD = data->psSTD;
+			snapshot->alsSTD = data->alsSTD;
+			snapshot->estimatedDistance = data->estimatedDistance;
+			snapshot->estimatedVelocity = data->estimatedVelocity;
+			snapshot->psOffset = data->psOffset;
+			snapshot->psVal = data->psVal;
+			snapshot->alsVal = data->alsVal;
+			snapshot->toggleCount = data->toggleCount;
+			snapshot->inProximity = data->inProximity;
+			snapshot->isBlocked = data->isBlocked;
+
+			SNAPSHOT_FENCE();
+			end = cell->seq;
+			if (begin == end) return retries;
+		}
+
+		if (retries < UINT8_MAX) retries++;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
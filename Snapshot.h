@@ -0,0 +1,124 @@
+/**
+ * @file Snapshot.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the published Sensor output snapshot, and related variables, methods
+ *
+ * The SnapshotCell object publishes a consistent copy of the derived Sensor outputs with a sequence lock.
+ * The single writer (sampling task, ISR or I2C completion) makes the sequence odd while it copies and even
+ * when done; readers copy without blocking the writer and retry if the sequence was odd or changed. No
+ * interrupts are disabled, and any number of readers may read concurrently.
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Sensor.h"
+
+/*
+ * On AVR an 8-bit sequence is read atomically and a compiler barrier is enough, as there is a single core.
+ * Elsewhere the sequence is 32-bit and full fences order it against the payload.
+ */
+#if defined(__AVR__)
+typedef uint8_t SnapshotSeq;
+#define SNAPSHOT_FENCE() __asm__ __volatile__ ("" ::: "memory")
+#else
+typedef uint32_t SnapshotSeq;
+#define SNAPSHOT_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/**
+ * @struct SensorSnapshot_t
+ * @brief Derived Sensor outputs, with the raw values they were derived from, published to readers
+ */
+typedef struct SensorSnapshot_t
+{
+	/** @brief \ref Sensor.sampleCount at publication */
+	uint32_t sampleCount;
+
+	/** @brief \ref Sensor.psMean */
+	uint16_t psMean;
+
+	/** @brief \ref Sensor.alsMean */
+	uint16_t alsMean;
+
+	/** @brief \ref Sensor.psSTD */
+	double psSTD;
+
+	/** @brief \ref Sensor.alsSTD */
+	double alsSTD;
+
+	/** @brief \ref Sensor.estimatedDistance */
+	double estimatedDistance;
+
+	/** @brief \ref Sensor.estimatedVelocity */
+	double estimatedVelocity;
+
+	/** @brief \ref Sensor.psOffset */
+	int16_t psOffset;
+
+	/** @brief Latest raw PS value processed */
+	uint16_t psVal;
+
+	/** @brief Latest raw ALS value processed */
+	uint16_t alsVal;
+
+	/** @brief Number of proximity entries counted by the caller */
+	uint32_t toggleCount;
+
+	/** @brief \ref Sensor.inProximity */
+	uint8_t inProximity;
+
+	/** @brief \ref Sensor.isBlocked */
+	uint8_t isBlocked;
+} SensorSnapshot;
+
+/**
+ * @struct SnapshotCell_t
+ * @brief Sequence locked snapshot
+ */
+typedef struct SnapshotCell_t
+{
+	/** @brief Sequence, odd while the writer is copying */
+	volatile SnapshotSeq seq;
+
+	/** @brief Published outputs */
+	SensorSnapshot data;
+} SnapshotCell;
+
+/**
+ * @brief Initialize cell with an all zero snapshot
+ *
+ * @param [out] cell
+ */
+void Init_Snapshot(SnapshotCell* cell);
+
+/**
+ * @brief Publish derived outputs of sensor, single writer only
+ *
+ * @param [out] cell
+ * @param [in] sensor
+ * @param [in] psVal latest raw PS value processed by sensor
+ * @param [in] alsVal latest raw ALS value processed by sensor
+ * @param [in] toggleCount
+ */
+void Snapshot_Publish(SnapshotCell* cell, const Sensor* sensor, uint16_t psVal, uint16_t alsVal, uint32_t toggleCount);
+
+/**
+ * @brief Read consistent copy of the latest published outputs
+ *
+ * @param [in] cell
+ * @param [out] snapshot
+ * @return number of retries needed
+ */
+uint8_t Snapshot_Read(const SnapshotCell* cell, SensorSnapshot* snapshot);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SNAPSHOT_H_ */
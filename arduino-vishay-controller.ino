@@ -1,7 +1,14 @@
 #include <Wire.h>
 #include <Adafruit_NeoPixel.h>
-#include <timer.h>
 #include "Sensor.h"
+#include "Scheduler.h"
+#include "Instrument.h"
+#include "RateControl.h"
+#include "RegCache.h"
+#include "PsPipeline.h"
+#include "FlightRecorder.h"
+#include "Snapshot.h"
+#include "SampleQueue.h"
 
 #define PIN        10
 #define PS_MIN_HYST 680
@@ -29,16 +36,9 @@
 #define ALS_CONF2                                   0x00  // sensitivity x2, White enabled
 #define PS_CONF1                                    0x3E  // PS enabled, PS interrupt persistence 4, 8T integration time
 #define PS_CONF2                                    0x4B  // PS 16-bit output, PS interrupt on closing/away, gesture enabled
-#define PS_CONF3                                    0x0D  // PS Sunlight Cancellation, active force mode, force trigger
+#define PS_CONF3                                    0x09  // PS Sunlight Cancellation, active force mode (trigger via RegCache_Trigger)
 #define PS_MS                                       0x07  // 200 mA LED_I current
-
-#define WRITE_DATA(CMD, LSB, MSB) {\
-  Wire.beginTransmission(DEVICE_ADDR);\
-  Wire.write(CMD);\
-  Wire.write(LSB);\
-  Wire.write(MSB);\
-  Wire.endTransmission(true);\
-}
+#define PS_CONVERSION_US                            1000UL  // Conservative force mode conversion time at 8T
 
 #define READ_DATA(DATA, CMD) {\
   Wire.beginTransmission(DEVICE_ADDR);\
@@ -49,6 +49,53 @@
   DATA[1] = Wire.read();\
 }
 
+// Task Macros, priority 0 is the highest
+#define SENSOR_PERIOD_US                            10000UL   // Active sampling period
+#define SENSOR_APPROACH_PERIOD_US                   30000UL   // PS rising toward PS_MAX_HYST
+#define SENSOR_IDLE_PERIOD_US                       100000UL  // Nothing near, PS flat
+#define SENSOR_DEADLINE_US                          5000UL
+#define SENSOR_PRIORITY                             0
+#define ALS_PERIOD_US                               50000UL   // Matches ALS_CONF1 integration time
+#define ALS_PRIORITY                                1
+#define PROCESS_PERIOD_US                           20000UL   // Fallback drain, released by every PS sample
+#define PROCESS_PRIORITY                            2
+#define PROCESS_BATCH                               8         // 80 ms of PS at the active period
+#define LED_PERIOD_US                               50000UL
+#define LED_PRIORITY                                3
+#define COLOUR_PERIOD_US                            2000000UL
+#define COLOUR_PRIORITY                             4
+#define SERIAL_PERIOD_US                            100000UL
+#define SERIAL_PRIORITY                             5
+#define COMMAND_PERIOD_US                           100000UL
+#define COMMAND_PRIORITY                            6
+
+// Adaptive Sampling Macros
+#define RATE_PS_APPROACH                            0     // proximityTable's farthest target, above resting PS
+#define RATE_PS_FLAT_STD                            4.0
+#define RATE_QUIET_SAMPLES                          100
+
+// Flight Recorder Macros, freeze after FR_TOGGLE_TRIGGER toggles within FR_TOGGLE_WINDOW_MS
+#define FR_TOGGLE_TRIGGER                           4
+#define FR_TOGGLE_WINDOW_MS                         2000UL
+#define FR_POST_SAMPLES                             100
+
+// Instrument scheduler task body with its start jitter and execution time
+#define TASK_INSTR_BEGIN(PROBE) INSTR_JITTER(PROBE, scheduler.tasks[scheduler.current].lastJitter); INSTR_BEGIN(PROBE)
+#define TASK_INSTR_END(PROBE) INSTR_END(PROBE)
+
+// Intensity Macros, 1 drives intensity from the window's least squares distance at the newest sample, which
+// does not trail hand motion by half the PS window, 0 from the window mean's estimatedDistance
+#define INTENSITY_PREDICTED                         1
+
+// Proximity Macros, hysteresis on the mean of the latest PS_FAST_WINDOW samples, which enters within a few
+// samples without the raw value's toggles on noise, while the PS window keeps the distance smooth
+#define PROXIMITY_FILTER                            SENSOR_FILTER_FAST
+
+// Baseline Macros, thresholds and proximityTable follow PS crosstalk drift from the baseline at boot, over
+// SENSOR_BASELINE_LEN blocks of BASELINE_DECIMATION samples (about 40 s at the active rate)
+#define BASELINE_REFERENCE                          0     // Taken from the first block
+#define BASELINE_DECIMATION                         256
+
 // LED Macros
 #define NUMPIXELS 15 // Popular NeoPixel ring size
 #define LED_R_VAL 255
@@ -58,19 +105,40 @@
 /*
  * Global Variable
  */
-auto timer = timer_create_default();  // Timer Helper Class
+Scheduler scheduler;  // Cooperative Task Scheduler
+const char* taskNames[SCHED_MAX_TASKS] = {0};
+int8_t sensorTask = SCHED_INVALID_TASK;
+int8_t processTask = SCHED_INVALID_TASK;
+RateControl rateControl;  // Adaptive Sampling Rate
+RegCache regCache;  // VCNL Register Shadow
+PsPipeline psPipeline;  // PS Conversion In Flight
+FlightRecorder recorder;  // Raw Sample History
+int8_t recorderDumpBlock = -1;  // Next block to dump, -1 when idle
+uint32_t toggleWindowStart = 0;
+uint8_t toggleWindowCount = 0;
+#ifdef INSTRUMENT
+const char* probeNames[PROBE_COUNT] = {
+  "sensorQuery", "alsQuery", "processQuery", "ledUpdate", "serialQuery", "changeColour",
+  "Update_Sensor_PS", "Update_Sensor_ALS", "Distance_Lookup"
+};
+int8_t instrDumpProbe = -1;  // Next probe to dump, -1 when idle
+#endif
 
 Adafruit_NeoPixel pixels(NUMPIXELS, PIN, NEO_GRB + NEO_KHZ800);
 volatile char readData[2] = {0};
 volatile uint32_t toggleCount = 0;
 volatile bool ledToggle = LOW;
-volatile uint16_t ps1_data, als_data;
 double intensity;
 
 uint16_t proximityTable[DIST_LOOKUP_LEN] = {
   65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
 };
 Sensor sensor;
+SensorBaseline sensorBaseline;  // Tracked PS crosstalk
+SensorSketch psSketch, alsSketch;  // Long horizon PS, ALS distributions
+int8_t sketchDumpChannel = -1;  // Next sketch to dump, 0 PS, 1 ALS, -1 when idle
+SnapshotCell sensorSnapshot;  // Consistent Sensor outputs for readers outside the sampling path
+SampleQueue sampleQueue;  // Raw samples from acquisition to processing
 
 #define NUMCOLOUR 9
 uint8_t LED_R[NUMCOLOUR] = { 255, 0,    0,    229,  255,  255, 255, 170,  0 };
@@ -78,18 +146,33 @@ uint8_t LED_G[NUMCOLOUR] = { 244, 242,  255,  255,  170,  0,   0,   0,    0 };
 uint8_t LED_B[NUMCOLOUR] = { 150, 255,  0,    0,    0,    38,  185, 255,  255 };
 bool isColourChanging = false;
 uint8_t colourIdx = 0;
-Timer<>::Task colourChangeTask;
+int8_t colourChangeTask = SCHED_INVALID_TASK;
 
 /*
  * Function Prototypes
  */
 void sensorSetup(void);
 bool sensorQuery(void *);
+bool alsQuery(void *);
+bool processQuery(void *);
 bool serialQuery(void *);
 bool changeColour(void *);
 bool ledUpdate(void *);
+bool commandQuery(void *);
 void sampleSensor(void);
+void processBatch(const SampleEntry* entries, uint8_t count);
 void setLED(double intensity);
+int8_t addTask(const char* name, SchedCallback callback, uint32_t period, uint32_t deadline, uint8_t priority);
+void printTaskStats(void);
+void printRegStats(void);
+void printPipelineStats(void);
+void printRecorderBlock(uint8_t n);
+void printQuantiles(void);
+void printSketch(int8_t channel);
+void checkToggleTrigger(void);
+uint8_t i2cWrite(uint8_t address, uint8_t cmd, uint8_t lsb, uint8_t msb);
+void printProbeStats(int8_t probe);
+uint32_t schedulerClock(void);
 
 void setup() {
   Wire.begin();
@@ -98,20 +181,50 @@ void setup() {
   pinMode(LED_BUILTIN, OUTPUT);
   digitalWrite(LED_BUILTIN, ledToggle);
 
+  // Register writes go through the shadow, so re-running sensorSetup() only writes registers differing
+  // from known state
+  Init_RegCache(&regCache, DEVICE_ADDR, i2cWrite);
   sensorSetup();
   
   pixels.begin();
   setLED(0.0);
 
-  // Set up timer tasks
-  timer.every(10, sensorQuery);
-  timer.every(100, serialQuery);
-  timer.every(50, ledUpdate);
+  // Set up scheduler tasks
+  Init_Scheduler(&scheduler, schedulerClock);
+#ifdef INSTRUMENT
+  Init_Instrument(schedulerClock);
+#endif
+  sensorTask = addTask("sensorQuery", sensorQuery, SENSOR_PERIOD_US, SENSOR_DEADLINE_US, SENSOR_PRIORITY);
+  addTask("alsQuery", alsQuery, ALS_PERIOD_US, 0, ALS_PRIORITY);
+  processTask = addTask("processQuery", processQuery, PROCESS_PERIOD_US, 0, PROCESS_PRIORITY);
+  addTask("serialQuery", serialQuery, SERIAL_PERIOD_US, 0, SERIAL_PRIORITY);
+  addTask("ledUpdate", ledUpdate, LED_PERIOD_US, 0, LED_PRIORITY);
+  addTask("commandQuery", commandQuery, COMMAND_PERIOD_US, 0, COMMAND_PRIORITY);
 }
 
 void loop() {
-  // Tick the timer forward to trigger assigned task callbacks
-  timer.tick();
+  // Run the highest priority ready task
+  Scheduler_Run(&scheduler);
+}
+
+uint32_t schedulerClock(void) {
+  return micros();
+}
+
+int8_t addTask(const char* name, SchedCallback callback, uint32_t period, uint32_t deadline, uint8_t priority) {
+  int8_t taskId = Scheduler_Add(&scheduler, callback, NULL, period, deadline, priority);
+  if (taskId != SCHED_INVALID_TASK) {
+    taskNames[taskId] = name;
+  }
+  return taskId;
+}
+
+uint8_t i2cWrite(uint8_t address, uint8_t cmd, uint8_t lsb, uint8_t msb) {
+  Wire.beginTransmission(address);
+  Wire.write(cmd);
+  Wire.write(lsb);
+  Wire.write(msb);
+  return Wire.endTransmission(true);
 }
 
 void sensorSetup(void) {
@@ -119,49 +232,161 @@ void sensorSetup(void) {
   READ_DATA(readData, CMD_DEVICE_ID);
 
   // ALS Config
-  WRITE_DATA(CMD_ALS_CONF1_2, ALS_CONF1, ALS_CONF2);
+  RegCache_Write(&regCache, CMD_ALS_CONF1_2, ALS_CONF1, ALS_CONF2);
 
   // Proximity Sensor Config
-  WRITE_DATA(CMD_PS_CONF1_2, PS_CONF1, PS_CONF2);
-  WRITE_DATA(CMD_PS_CONF3_MS, PS_CONF3, PS_MS);
+  RegCache_Write(&regCache, CMD_PS_CONF1_2, PS_CONF1, PS_CONF2);
+  RegCache_Write(&regCache, CMD_PS_CONF3_MS, PS_CONF3, PS_MS);
 
   // PS INT Settings
-  WRITE_DATA(CMD_PS_THDL, PS_THDL_L, PS_THDL_M);
-  WRITE_DATA(CMD_PS_THDH, PS_THDH_L, PS_THDH_M);
+  RegCache_Write(&regCache, CMD_PS_THDL, PS_THDL_L, PS_THDL_M);
+  RegCache_Write(&regCache, CMD_PS_THDH, PS_THDH_L, PS_THDH_M);
   
   // Clear any interrupt flags
   READ_DATA(readData, CMD_INT_FLAG);
 
+  // Start the first conversion, each sample reads it and triggers the next
+  Init_PsPipeline(&psPipeline, PS_CONVERSION_US);
+  if (RegCache_Trigger(&regCache, CMD_PS_CONF3_MS) == 0) {
+    PsPipeline_Trigger(&psPipeline, micros());
+  }
+
   // Set up sensor struct
   Init_Sensor(&sensor, 0, PS_MIN_HYST, PS_MAX_HYST, proximityTable);
+  sensor.psFilter = PROXIMITY_FILTER;
+  Init_Sensor_Baseline(&sensorBaseline, BASELINE_REFERENCE, BASELINE_DECIMATION);
+  Set_PS_Baseline(&sensor, &sensorBaseline);
+  Init_Sensor_Sketch(&psSketch);
+  Init_Sensor_Sketch(&alsSketch);
+  Set_Sensor_Sketch(&sensor, &psSketch, &alsSketch);
+  Init_FlightRecorder(&recorder);
+  Init_Snapshot(&sensorSnapshot);
+  Init_SampleQueue(&sampleQueue);
+  Init_RateControl(&rateControl, SENSOR_PERIOD_US, SENSOR_APPROACH_PERIOD_US, SENSOR_IDLE_PERIOD_US,
+      RATE_PS_APPROACH, RATE_PS_FLAT_STD, RATE_QUIET_SAMPLES);
 }
 
 bool sensorQuery(void *) {
+  TASK_INSTR_BEGIN(PROBE_SENSOR_QUERY);
   sampleSensor();
+  TASK_INSTR_END(PROBE_SENSOR_QUERY);
+  return true;
+}
+
+bool alsQuery(void *) {
+  // ALS is read once per integration time, so every read is a fresh conversion
+  TASK_INSTR_BEGIN(PROBE_ALS_QUERY);
+  READ_DATA(readData, CMD_ALS_DATA);
+  SampleQueue_Push(&sampleQueue, micros(), 0, *((uint16_t*)readData), SAMPLE_ALS);
+  TASK_INSTR_END(PROBE_ALS_QUERY);
+  return true;
+}
+
+bool processQuery(void *) {
+  // Drain everything acquired since the last run, processing in batches
+  SampleEntry batch[PROCESS_BATCH];
+  uint8_t count;
+
+  TASK_INSTR_BEGIN(PROBE_PROCESS_QUERY);
+  while ((count = SampleQueue_Pop(&sampleQueue, batch, PROCESS_BATCH)) > 0) {
+    processBatch(batch, count);
+  }
+
   digitalWrite(LED_BUILTIN, ledToggle);
+  TASK_INSTR_END(PROBE_PROCESS_QUERY);
   return true;
 }
 
 void sampleSensor(void) {
-  WRITE_DATA(CMD_PS_CONF3_MS, PS_CONF3, PS_MS);  
-  READ_DATA(readData, CMD_PS1_DATA);
-  ps1_data = *((uint16_t*)readData);
-  READ_DATA(readData, CMD_ALS_DATA);
-  als_data = *((uint16_t*)readData);
+  bool isValid = false;
+  uint32_t sampleTime = psPipeline.triggerTime;
+
+  // Read the conversion triggered on the previous run, then trigger the next one so the sensor
+  // integrates while samples are processed
+  if (psPipeline.pending) {
+    READ_DATA(readData, CMD_PS1_DATA);
+    isValid = PsPipeline_Read(&psPipeline, micros());
+  }
 
-  Update_Sensor(&sensor, ps1_data, als_data);
+  if (RegCache_Trigger(&regCache, CMD_PS_CONF3_MS) == 0) {
+    PsPipeline_Trigger(&psPipeline, micros());
+  } else {
+    // Restore a configuration lost to a failed write, so the next sample triggers
+    RegCache_Write(&regCache, CMD_PS_CONF3_MS, PS_CONF3, PS_MS);
+  }
+
+  if (!isValid) return;
+
+  SampleQueue_Push(&sampleQueue, sampleTime, *((uint16_t*)readData), 0, SAMPLE_PS);
+
+  // Process right after acquisition, so proximity and the sampling period follow each PS sample
+  Scheduler_Release(&scheduler, processTask);
+}
+
+void processBatch(const SampleEntry* entries, uint8_t count) {
+  uint8_t lastPS = count;
+  uint16_t entered = 0;
+  static uint16_t psVal = 0, alsVal = 0;  // Latest samples processed, in acquisition order
+  uint32_t period = RateControl_Period(&rateControl);  // Period the batch was sampled at
+  bool periodChanged = false;
+  bool wasInProximity;
+
+  // The last PS sample derives the means, STD and distances once for the batch
+  for (uint8_t i = count; i-- > 0; ) {
+    if (entries[i].channels & SAMPLE_PS) {
+      lastPS = i;
+      break;
+    }
+  }
+
+  // Samples in acquisition order, so the blocked flag sees the ALS window of each PS sample, and hysteresis
+  // and rate control see every raw PS sample with its own proximity state. Rate control takes the PS STD of
+  // the last derived update. Each raw PS sample is recorded with the latest ALS sample acquired before it.
+  for (uint8_t i = 0; i < count; i++) {
+    if (entries[i].channels & SAMPLE_ALS) {
+      alsVal = entries[i].alsVal;
+      Update_Sensor_ALS(&sensor, alsVal);
+    }
+    if (entries[i].channels & SAMPLE_PS) {
+      psVal = entries[i].psVal;
+      FlightRecorder_Record(&recorder, entries[i].time / 1000, period / 1000, psVal, alsVal);
+      if (i == lastPS) {
+        wasInProximity = sensor.inProximity;
+        Update_Sensor_PS(&sensor, psVal);
+        if (!wasInProximity && sensor.inProximity) entered++;
+      } else {
+        entered += Update_Sensor_PS_Sample(&sensor, psVal);
+      }
+      periodChanged |= RateControl_Update(&rateControl, &sensor, psVal);
+    }
+  }
+
+  if (lastPS == count) {
+    Snapshot_Publish(&sensorSnapshot, &sensor, psVal, alsVal, toggleCount);
+    return;
+  }
+
+  // The new period applies after the next release
+  if (periodChanged) {
+    Scheduler_Set_Period(&scheduler, sensorTask, RateControl_Period(&rateControl));
+  }
   
-  if (!ledToggle && sensor.inProximity) {
+  // Count every proximity entry within the batch
+  while (entered-- > 0) {
     toggleCount += 1;
+    checkToggleTrigger();
   }
+  Snapshot_Publish(&sensorSnapshot, &sensor, psVal, alsVal, toggleCount);
 
   ledToggle = sensor.inProximity;
 
   // Update intensity if inProximity
   if (ledToggle) {
+    double distance = INTENSITY_PREDICTED ? sensor.predictedDistance : sensor.estimatedDistance;
+
     // First, normalize in distance range, then use tan(x) as activation function, saturate at 1
-    intensity = min(sensor.estimatedDistance, 25);
-    intensity = max(sensor.estimatedDistance, 5);
+    intensity = min(distance, 25);
+    intensity = max(distance, 5);
     
     intensity = (intensity - 5)/20;
     intensity = tan(intensity * 0.8);
@@ -173,12 +398,13 @@ void sampleSensor(void) {
   // If controller shows LED as on right now
   if (((toggleCount % 2) != 0)) {
     if ((sensor.estimatedDistance <= 5) && !isColourChanging) {
-      colourChangeTask = timer.every(2000, changeColour);
+      colourChangeTask = addTask("changeColour", changeColour, COLOUR_PERIOD_US, 0, COLOUR_PRIORITY);
       isColourChanging = true;
     }
     
     if ((sensor.estimatedDistance > 5) && isColourChanging) {
-      timer.cancel(colourChangeTask);
+      Scheduler_Cancel(&scheduler, colourChangeTask);
+      colourChangeTask = SCHED_INVALID_TASK;
       isColourChanging = false;
     }
   }
@@ -198,35 +424,260 @@ void setLED(double intensity) {
 // Timer callback functions
 
 bool serialQuery(void *) {
+  TASK_INSTR_BEGIN(PROBE_SERIAL_QUERY);
+  SensorSnapshot snapshot;
+  Snapshot_Read(&sensorSnapshot, &snapshot);
+
   // Update latest data every 10 ms
-  Serial.print(ps1_data);
+  Serial.print(snapshot.psVal);
   Serial.print(",");
-  Serial.print(als_data);
+  Serial.print(snapshot.alsVal);
   Serial.print("\t\t");
-  Serial.print(toggleCount);
+  Serial.print(snapshot.toggleCount);
+  Serial.print(",");
+  Serial.print(snapshot.psMean);
   Serial.print(",");
-  Serial.print(sensor.psMean);
+  Serial.print(snapshot.alsMean);
   Serial.print(",");
-  Serial.print(sensor.alsMean);
+  Serial.print(snapshot.estimatedDistance);
   Serial.print(",");
-  Serial.print(sensor.estimatedDistance);
+  Serial.print(snapshot.inProximity);
   Serial.print(",");
-  Serial.print(sensor.inProximity);
+  Serial.print(snapshot.psOffset);
   Serial.println("");
+  TASK_INSTR_END(PROBE_SERIAL_QUERY);
   return true;
 }
 
 bool ledUpdate(void *) {
+  TASK_INSTR_BEGIN(PROBE_LED_UPDATE);
   if ((toggleCount % 2) == 1) {
     setLED(intensity);
   } else {
     setLED(0);
   }
+  TASK_INSTR_END(PROBE_LED_UPDATE);
 
   return true;
 }
 
 bool changeColour(void *) {
+  TASK_INSTR_BEGIN(PROBE_CHANGE_COLOUR);
   colourIdx = (colourIdx + 1) % NUMCOLOUR;
+  TASK_INSTR_END(PROBE_CHANGE_COLOUR);
+  return true;
+}
+
+bool commandQuery(void *) {
+  // Dump one recorder block per run, for the same reason as the probe dump below
+  if (recorderDumpBlock >= 0) {
+    printRecorderBlock(recorderDumpBlock);
+    recorderDumpBlock = (recorderDumpBlock + 1 < recorder.used) ? recorderDumpBlock + 1 : -1;
+  }
+
+  // Dump one sketch per run, likewise
+  if (sketchDumpChannel >= 0) {
+    printSketch(sketchDumpChannel);
+    sketchDumpChannel = (sketchDumpChannel < 1) ? sketchDumpChannel + 1 : -1;
+  }
+
+#ifdef INSTRUMENT
+  // Dump one probe per run so a dump never holds up higher priority tasks for long
+  if (instrDumpProbe >= 0) {
+    printProbeStats(instrDumpProbe);
+    instrDumpProbe = (instrDumpProbe + 1 < PROBE_COUNT) ? instrDumpProbe + 1 : -1;
+  }
+#endif
+
+  // Single character commands: 's' prints task statistics, 'r' resets them,
+  // 'w' prints register write statistics, 'a' prints queue and PS sample age,
+  // 'f' dumps the flight recorder, 'F' re-arms it, 'q' prints PS, ALS quantiles, 'k' dumps their sketches,
+  // 'K' clears them, 'i' dumps instrumentation histograms, 'c' clears them
+  while (Serial.available() > 0) {
+    switch (Serial.read()) {
+      case 's':
+        printTaskStats();
+        break;
+      case 'r':
+        Scheduler_Reset_Stats(&scheduler);
+        break;
+      case 'w':
+        printRegStats();
+        break;
+      case 'a':
+        printPipelineStats();
+        break;
+      case 'f':
+        recorderDumpBlock = (recorder.used > 0) ? 0 : -1;
+        break;
+      case 'F':
+        FlightRecorder_Rearm(&recorder);
+        recorderDumpBlock = -1;
+        break;
+      case 'q':
+        printQuantiles();
+        break;
+      case 'k':
+        sketchDumpChannel = 0;
+        break;
+      case 'K':
+        Init_Sensor_Sketch(&psSketch);
+        Init_Sensor_Sketch(&alsSketch);
+        sketchDumpChannel = -1;
+        break;
+#ifdef INSTRUMENT
+      case 'i':
+        instrDumpProbe = 0;
+        break;
+      case 'c':
+        Reset_Instrument();
+        break;
+#endif
+      default:
+        break;
+    }
+  }
   return true;
 }
+
+void printTaskStats(void) {
+  // task,runs,misses,overruns,lastJitter,maxJitter,meanJitter,lastExec,maxExec (times in us)
+  for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+    SchedTask* task = &scheduler.tasks[i];
+    if (task->callback == NULL) continue;
+
+    Serial.print(taskNames[i]);
+    Serial.print(",");
+    Serial.print(task->runCount);
+    Serial.print(",");
+    Serial.print(task->missCount);
+    Serial.print(",");
+    Serial.print(task->overrunCount);
+    Serial.print(",");
+    Serial.print(task->lastJitter);
+    Serial.print(",");
+    Serial.print(task->maxJitter);
+    Serial.print(",");
+    Serial.print(task->runCount ? (task->jitterSum / task->runCount) : 0);
+    Serial.print(",");
+    Serial.print(task->lastExec);
+    Serial.print(",");
+    Serial.print(task->maxExec);
+    Serial.println("");
+  }
+}
+
+void printRegStats(void) {
+  // regs,written,avoided,triggers
+  Serial.print("regs,");
+  Serial.print(regCache.writeCount);
+  Serial.print(",");
+  Serial.print(regCache.avoidedCount);
+  Serial.print(",");
+  Serial.print(regCache.triggerCount);
+  Serial.println("");
+}
+
+void printPipelineStats(void) {
+  // queue,overflows,highWater
+  Serial.print("queue,");
+  Serial.print(sampleQueue.overflowCount);
+  Serial.print(",");
+  Serial.print(sampleQueue.highWater);
+  Serial.println("");
+
+  // psAge,reads,early,lastAge,maxAge (times in us)
+  Serial.print("psAge,");
+  Serial.print(psPipeline.readCount);
+  Serial.print(",");
+  Serial.print(psPipeline.earlyCount);
+  Serial.print(",");
+  Serial.print(psPipeline.lastAge);
+  Serial.print(",");
+  Serial.print(psPipeline.maxAge);
+  Serial.println("");
+}
+
+void checkToggleTrigger(void) {
+  // Rapid toggling (flicker) freezes the flight recorder shortly after the event
+  uint32_t now = millis();
+
+  if ((now - toggleWindowStart) > FR_TOGGLE_WINDOW_MS) {
+    toggleWindowStart = now;
+    toggleWindowCount = 0;
+  }
+
+  if (++toggleWindowCount >= FR_TOGGLE_TRIGGER) {
+    FlightRecorder_Trigger(&recorder, FR_POST_SAMPLES);
+  }
+}
+
+void printRecorderBlock(uint8_t n) {
+  // fr,<block>,<frozen>,<block bytes in hex>, decoded on the host by host/fr_decode
+  const uint8_t* block = FlightRecorder_Block(&recorder, n);
+  if (block == NULL) return;
+
+  Serial.print("fr,");
+  Serial.print(n);
+  Serial.print(",");
+  Serial.print(recorder.frozen);
+  Serial.print(",");
+  for (int i = 0; i < FR_BLOCK_LEN; i++) {
+    if (block[i] < 0x10) Serial.print("0");
+    Serial.print(block[i], HEX);
+  }
+  Serial.println("");
+}
+
+void printQuantiles(void) {
+  // quantiles,<ps p5>,<ps p50>,<ps p95>,<als p5>,<als p50>,<als p95>
+  const double q[3] = { 0.05, 0.5, 0.95 };
+
+  Serial.print("quantiles");
+  for (int i = 0; i < 6; i++) {
+    Serial.print(",");
+    Serial.print(Sensor_Sketch_Quantile((i < 3) ? &psSketch : &alsSketch, q[i % 3]));
+  }
+  Serial.println("");
+}
+
+void printSketch(int8_t channel) {
+  // sk,<ps|als>,<halvings>,<total>,<4 hex digits per count>, merged on the host by host/sketch_merge
+  const SensorSketch* sketch = (channel == 0) ? &psSketch : &alsSketch;
+
+  Serial.print((channel == 0) ? "sk,ps," : "sk,als,");
+  Serial.print(sketch->halvings);
+  Serial.print(",");
+  Serial.print(sketch->total);
+  Serial.print(",");
+  for (int i = 0; i < SENSOR_SKETCH_LEN; i++) {
+    for (int shift = 12; shift >= 0; shift -= 4) {
+      Serial.print((sketch->count[i] >> shift) & 0xF, HEX);
+    }
+  }
+  Serial.println("");
+}
+
+void printProbeStats(int8_t probe) {
+#ifdef INSTRUMENT
+  // probe,maxExec,maxJitter,E:<exec bins>,J:<jitter bins> (bin n counts [2^(n-1), 2^n) us)
+  InstrStats* stats = &instrStats[probe];
+
+  Serial.print(probeNames[probe]);
+  Serial.print(",");
+  Serial.print(stats->maxExec);
+  Serial.print(",");
+  Serial.print(stats->maxJitter);
+  Serial.print(",E:");
+  for (int i = 0; i < INSTR_HIST_BINS; i++) {
+    Serial.print(stats->execHist[i]);
+    Serial.print(" ");
+  }
+  Serial.print(",J:");
+  for (int i = 0; i < INSTR_HIST_BINS; i++) {
+    Serial.print(stats->jitterHist[i]);
+    Serial.print(" ");
+  }
+  Serial.println("");
+#endif
+}
@@ -0,0 +1,111 @@
+/**
+ * @file FleetInstance.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the fleet firmware image entry points, and related variables, methods
+ *
+ * libfleet_fw.so holds the sketch, the Arduino shims and the simulated bus and clock, built with hidden
+ * visibility so every global of one controller lives in the library's writable data. That data is the
+ * instance context: fleet_sim loads one copy of the library per worker thread and swaps instance images in
+ * and out of it, like RAM images of the MCU. Only these entry points are exported.
+ */
+
+#ifndef FLEETINSTANCE_H_
+#define FLEETINSTANCE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "SimTrace.h"
+
+/**
+ * @struct FleetConfig_t
+ * @brief Per-instance signal and timing parameters
+ */
+typedef struct FleetConfig_t
+{
+	/** @brief Seed of the synthetic signal, must not be 0 */
+	uint32_t seed;
+
+	/** @brief Time between synthetic hand approaches (in us) */
+	uint64_t handPeriod;
+
+	/** @brief Time of the first synthetic hand approach (in us) */
+	uint64_t handPhase;
+
+	/** @brief Recorded trace replacing the synthetic signal, NULL if none, shared read-only */
+	const SimTrace* trace;
+
+	/** @brief Trace time at virtual time 0 (in ms) */
+	uint32_t traceOffset;
+
+	/** @brief CPU time charged per loop() (in us) */
+	uint32_t taskCost;
+} FleetConfig;
+
+/**
+ * @struct FleetCounters_t
+ * @brief Instance state read back for fleet statistics
+ */
+typedef struct FleetCounters_t
+{
+	/** @brief Virtual time (in us) */
+	uint64_t now;
+
+	/** @brief Number of loop() calls */
+	uint64_t loops;
+
+	/** @brief Bytes written to Serial, the telemetry sent to the gateway */
+	uint32_t serialBytes;
+
+	/** @brief Proximity toggles counted by the sketch */
+	uint32_t toggles;
+
+	/** @brief Changed NeoPixel frames */
+	uint32_t frames;
+
+	/** @brief PS reads of a conversion in flight */
+	uint32_t staleReads;
+
+	/** @brief Task deadline misses */
+	uint32_t misses;
+
+	/** @brief Task releases skipped by overruns */
+	uint32_t overruns;
+} FleetCounters;
+
+/**
+ * @brief Set up simulated sensor and run the sketch's setup()
+ *
+ * @param [in] config
+ */
+typedef void (*FleetSetup)(const FleetConfig* config);
+
+/**
+ * @brief Run the sketch until a virtual time
+ *
+ * @param [in] until (in us)
+ */
+typedef void (*FleetRun)(uint64_t until);
+
+/**
+ * @brief Read instance counters
+ *
+ * @param [out] counters
+ */
+typedef void (*FleetRead)(FleetCounters* counters);
+
+/*
+ * Entry point names, resolved with dlsym() in every loaded copy
+ */
+#define FLEET_SETUP_SYMBOL "Fleet_Setup"
+#define FLEET_RUN_SYMBOL "Fleet_Run"
+#define FLEET_READ_SYMBOL "Fleet_Read"
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* FLEETINSTANCE_H_ */
@@ -0,0 +1,34 @@
+/**
+ * @file SimClock.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the host virtual clock, and related variables, methods
+ *
+ * Host simulations run on a virtual microsecond clock that only moves when advanced, either explicitly or by
+ * simulated bus transactions, so simulated time is independent of host speed.
+ */
+
+
+#include "SimClock.h"
+
+static uint64_t simTime = 0;
+
+uint64_t Sim_Now(void)
+{
+	return simTime;
+}
+
+uint32_t Sim_Micros(void)
+{
+	return (uint32_t) simTime;
+}
+
+void Sim_Advance(uint64_t us)
+{
+	simTime += us;
+}
+
+void Sim_Set(uint64_t us)
+{
+	simTime = us;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file SimClock.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the host virtual clock, and related variables, methods
+ *
+ * Host simulations run on a virtual microsecond clock that only moves when advanced, either explicitly or by
+ * simulated bus transactions, so simulated time is independent of host speed.
+ */
+
+#ifndef SIMCLOCK_H_
+#define SIMCLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Current virtual time
+ *
+ * @return time (in us)
+ */
+uint64_t Sim_Now(void);
+
+/**
+ * @brief Current virtual time truncated to 32 bits, as a firmware clock
+ *
+ * @return time (in us)
+ */
+uint32_t Sim_Micros(void);
+
+/**
+ * @brief Advance virtual time
+ *
+ * @param [in] us
+ */
+void Sim_Advance(uint64_t us);
+
+/**
+ * @brief Set virtual time
+ *
+ * @param [in] us
+ */
+void Sim_Set(uint64_t us);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SIMCLOCK_H_ */
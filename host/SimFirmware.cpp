@@ -0,0 +1,82 @@
+/**
+ * @file SimFirmware.cpp
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for running the sketch on the virtual clock, and related variables, methods
+ *
+ * Shared by the single controller simulator and the fleet instances: the sketch's loop() is called whenever
+ * a task is ready, otherwise virtual time jumps to the next release as the MCU would spin. A synthetic
+ * periodic hand approach serves as signal source for the simulated VCNL, see SimTrace.h for recorded ones.
+ */
+
+#include <math.h>
+#include <Arduino.h>
+#include "SimFirmware.h"
+#include "SimClock.h"
+#include "Scheduler.h"
+
+/** @brief Sketch task table */
+extern Scheduler scheduler;
+
+/**
+ * @brief Jump virtual time to the next task release if no task is ready
+ */
+static void Skip_Idle(void)
+{
+	uint32_t now = Sim_Micros();
+	int32_t wait = INT32_MAX;
+	uint8_t i;
+
+	for (i = 0; i < SCHED_MAX_TASKS; i++)
+	{
+		SchedTask* task = &scheduler.tasks[i];
+		if (task->callback == NULL) continue;
+
+		if (SCHED_TIME_REACHED(now, task->nextRelease)) return;
+		if ((int32_t) (task->nextRelease - now) < wait) wait = (int32_t) (task->nextRelease - now);
+	}
+
+	if (wait != INT32_MAX) Sim_Advance((uint32_t) wait);
+}
+
+uint64_t SimFirmware_Run(uint64_t until, uint32_t taskCost)
+{
+	uint64_t loops = 0;
+
+	while (Sim_Now() < until)
+	{
+		Skip_Idle();
+		loop();
+		Sim_Advance(taskCost);
+		loops++;
+	}
+
+	return loops;
+}
+
+static uint32_t Hand_Noise(SimHand* hand)
+{
+	//	xorshift32
+	hand->seed ^= hand->seed << 13;
+	hand->seed ^= hand->seed >> 17;
+	hand->seed ^= hand->seed << 5;
+	return hand->seed;
+}
+
+uint16_t SimHand_PS(void* ctx, uint64_t now)
+{
+	SimHand* hand = (SimHand *) ctx;
+	uint64_t phase = (now + hand->period - hand->phase % hand->period) % hand->period;
+	double x = 0;
+
+	//	Raised sine up to ~1000 counts over the baseline
+	if (phase < hand->duration)
+		x = 0.5 - 0.5 * cos(2 * M_PI * (double) phase / hand->duration);
+
+	return (uint16_t) (650 + Hand_Noise(hand) % 9 + 1000 * x);
+}
+
+uint16_t SimHand_ALS(void* ctx, uint64_t now)
+{
+	return (uint16_t) (200 + Hand_Noise((SimHand *) ctx) % 5);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file SimFirmware.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for running the sketch on the virtual clock, and related variables, methods
+ *
+ * Shared by the single controller simulator and the fleet instances: the sketch's loop() is called whenever
+ * a task is ready, otherwise virtual time jumps to the next release as the MCU would spin. A synthetic
+ * periodic hand approach serves as signal source for the simulated VCNL, see SimTrace.h for recorded ones.
+ */
+
+#ifndef SIMFIRMWARE_H_
+#define SIMFIRMWARE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @struct SimHand_t
+ * @brief Baseline with noise and a periodic hand approach
+ */
+typedef struct SimHand_t
+{
+	/** @brief Noise generator state, must not be 0 */
+	uint32_t seed;
+
+	/** @brief Time between approaches (in us) */
+	uint64_t period;
+
+	/** @brief Duration of an approach and retreat (in us) */
+	uint64_t duration;
+
+	/** @brief Time of the first approach (in us) */
+	uint64_t phase;
+} SimHand;
+
+/**
+ * @brief Run the sketch until a virtual time
+ *
+ * @param [in] until (in us)
+ * @param [in] taskCost CPU time charged per loop() (in us)
+ * @return number of loop() calls
+ */
+uint64_t SimFirmware_Run(uint64_t until, uint32_t taskCost);
+
+/**
+ * @brief Hand signal PS value, a SimSignal
+ *
+ * @param [in] ctx SimHand
+ * @param [in] now (in us)
+ * @return PS counts
+ */
+uint16_t SimHand_PS(void* ctx, uint64_t now);
+
+/**
+ * @brief Hand signal ALS value, a SimSignal
+ *
+ * @param [in] ctx SimHand
+ * @param [in] now (in us)
+ * @return ALS counts
+ */
+uint16_t SimHand_ALS(void* ctx, uint64_t now);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SIMFIRMWARE_H_ */
@@ -0,0 +1,610 @@
+/**
+ * @file SimGen.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the synthetic PS/ALS workload generator, and related variables, methods
+ *
+ * Generates PS/ALS sample streams at a fixed sample period: hand approach and retreat, hovering, swipes and
+ * sensor blocking on the hand side, sunlight steps, IR noise bursts and slow PS drift on the ambient side.
+ * Hand gestures come from a script or are drawn at random; ambient events are always drawn at random from
+ * their mean intervals, an interval of 0 disables them.
+ *
+ * The PS response to the hand distance follows the proximity table and #distanceTable, inverted at
+ * Init_SimGen() into a curve with 64 points per distance unit, so Distance_Lookup() of a noise free sample
+ * returns the hand distance. Parameters only change at event boundaries: in between, a sample costs a
+ * curve and a noise table lookup, so generation runs at hundreds of millions of samples per second.
+ */
+
+#include <stddef.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "SimGen.h"
+#include "Sensor.h"
+
+/** @brief Fractional bits of hand distances */
+#define SIMGEN_POSITION_BITS 16
+
+/** @brief Duration of one hover wobble (in ms) */
+#define SIMGEN_HOVER_MS 250
+
+/** @brief Time between drift rate changes (in ms) */
+#define SIMGEN_DRIFT_MS 10000
+
+/** @brief Noise table distance between PS and ALS noise, so the two are uncorrelated */
+#define SIMGEN_ALS_LAG 1531
+
+/**
+ * @brief Next random value, xorshift32
+ *
+ * @param [out] gen
+ * @return random value
+ */
+static uint32_t Next_Random(SimGen* gen)
+{
+	gen->random ^= gen->random << 13;
+	gen->random ^= gen->random >> 17;
+	gen->random ^= gen->random << 5;
+	return gen->random;
+}
+
+/**
+ * @brief Uniform random value in a range
+ *
+ * @param [out] gen
+ * @param [in] low
+ * @param [in] high inclusive
+ * @return random value
+ */
+static uint32_t Uniform(SimGen* gen, uint32_t low, uint32_t high)
+{
+	return low + Next_Random(gen) % (high - low + 1);
+}
+
+/**
+ * @brief Duration in samples, at least 1
+ *
+ * @param [in] gen
+ * @param [in] ms
+ * @return samples
+ */
+static uint32_t Samples(const SimGen* gen, uint32_t ms)
+{
+	uint64_t samples = (uint64_t) ms * 1000 / gen->config.samplePeriod;
+	if (samples > UINT32_MAX) return UINT32_MAX;
+	return samples ? (uint32_t) samples : 1;
+}
+
+/**
+ * @brief Random time to the next ambient event, uniform from half to one and a half of the mean
+ *
+ * @param [out] gen
+ * @param [in] mean (in ms), 0 for never
+ * @return samples
+ */
+static uint32_t Interval(SimGen* gen, uint32_t mean)
+{
+	if (mean == 0) return UINT32_MAX;
+	return Samples(gen, Uniform(gen, mean / 2, mean + mean / 2));
+}
+
+/**
+ * @brief Hand distance within the curve
+ *
+ * @param [in] gen
+ * @param [in] position (in 1/65536 distance units)
+ * @return clamped position
+ */
+static int32_t Clamp_Position(const SimGen* gen, int32_t position)
+{
+	int32_t far = (int32_t) gen->config.farDistance << SIMGEN_POSITION_BITS;
+
+	if (position < 0) return 0;
+	return (position > far) ? far : position;
+}
+
+/**
+ * @brief Queue a hand segment, dropped if the queue is full
+ *
+ * @param [out] gen
+ * @param [in] target (in 1/65536 distance units)
+ * @param [in] length (in samples)
+ * @param [in] blocked
+ */
+static void Push_Segment(SimGen* gen, int32_t target, uint32_t length, uint8_t blocked)
+{
+	SimGenSegment* segment;
+
+	if (gen->segmentCount == SIMGEN_MAX_SEGMENTS) return;
+
+	segment = &gen->segments[(gen->segmentHead + gen->segmentCount) % SIMGEN_MAX_SEGMENTS];
+	segment->target = Clamp_Position(gen, target);
+	segment->length = length;
+	segment->blocked = blocked;
+	gen->segmentCount++;
+	gen->segmentEnd = segment->target;
+}
+
+/**
+ * @brief Queue the segments of a gesture, from the end of the pending ones
+ *
+ * @param [out] gen
+ * @param [in] event
+ */
+static void Expand_Event(SimGen* gen, const SimGenEvent* event)
+{
+	int32_t from = gen->segmentEnd;
+	int32_t distance = (int32_t) event->distance << (SIMGEN_POSITION_BITS - SIMGEN_CURVE_BITS);
+	uint32_t length = Samples(gen, event->duration);
+	uint32_t pieces, piece, k;
+
+	switch (event->motion)
+	{
+		case SIMGEN_HOLD:
+			Push_Segment(gen, from, length, 0);
+			break;
+		case SIMGEN_APPROACH:
+			Push_Segment(gen, distance, length, 0);
+			break;
+		case SIMGEN_HOVER:
+			//	Alternating moves to random points within the distance, back to the start at the end
+			pieces = event->duration / SIMGEN_HOVER_MS;
+			if (pieces < 1) pieces = 1;
+			if (pieces > SIMGEN_MAX_SEGMENTS / 2) pieces = SIMGEN_MAX_SEGMENTS / 2;
+			piece = (length / pieces) ? length / pieces : 1;
+			for (k = 0; k + 1 < pieces; k++)
+			{
+				int32_t wobble = (int32_t) (Next_Random(gen) % ((uint32_t) distance + 1));
+				Push_Segment(gen, (k & 1) ? from - wobble : from + wobble, piece, 0);
+			}
+			Push_Segment(gen, from, (length > piece * k) ? length - piece * k : 1, 0);
+			break;
+		case SIMGEN_RETREAT:
+			Push_Segment(gen, (int32_t) gen->config.farDistance << SIMGEN_POSITION_BITS, length, 0);
+			break;
+		case SIMGEN_SWIPE:
+			Push_Segment(gen, distance, (length / 2) ? length / 2 : 1, 0);
+			Push_Segment(gen, from, (length - length / 2) ? length - length / 2 : 1, 0);
+			break;
+		case SIMGEN_BLOCK:
+			Push_Segment(gen, 0, length, 1);
+			break;
+	}
+}
+
+/**
+ * @brief Queue a random gesture followed by a random pause
+ *
+ * @param [out] gen
+ */
+static void Random_Gesture(SimGen* gen)
+{
+	SimGenEvent event;
+	uint32_t kind = Next_Random(gen) % 8;
+
+	event.distance = Uniform(gen, SIMGEN_DISTANCE(1), SIMGEN_DISTANCE(20));
+	event.duration = Uniform(gen, 300, 800);
+
+	if (kind < 5)
+	{
+		//	Approach, hover over the sensor for a while if kind < 3, retreat
+		event.motion = SIMGEN_APPROACH;
+		Expand_Event(gen, &event);
+		if (kind < 3)
+		{
+			event.motion = SIMGEN_HOVER;
+			event.distance = SIMGEN_DISTANCE(1);
+			event.duration = Uniform(gen, 500, 2000);
+			Expand_Event(gen, &event);
+		}
+	}
+	else if (kind < 7)
+	{
+		event.motion = SIMGEN_SWIPE;
+		event.distance = Uniform(gen, SIMGEN_DISTANCE(3), SIMGEN_DISTANCE(12));
+		event.duration = Uniform(gen, 150, 300);
+		Expand_Event(gen, &event);
+	}
+	else
+	{
+		//	Reach for the sensor and cover it
+		event.motion = SIMGEN_APPROACH;
+		event.distance = SIMGEN_DISTANCE(2);
+		event.duration = Uniform(gen, 200, 400);
+		Expand_Event(gen, &event);
+		event.motion = SIMGEN_BLOCK;
+		event.duration = Uniform(gen, 1000, 3000);
+		Expand_Event(gen, &event);
+	}
+
+	if (kind < 5 || kind == 7)
+	{
+		event.motion = SIMGEN_RETREAT;
+		event.duration = Uniform(gen, 300, 800);
+		Expand_Event(gen, &event);
+	}
+
+	event.motion = SIMGEN_HOLD;
+	event.duration = Uniform(gen, gen->config.handInterval / 2, gen->config.handInterval + gen->config.handInterval / 2);
+	Expand_Event(gen, &event);
+
+	gen->gestureCount++;
+}
+
+/**
+ * @brief Start the next hand segment, queueing the next gesture if none is pending
+ *
+ * @param [out] gen
+ */
+static void Next_Segment(SimGen* gen)
+{
+	SimGenSegment* segment;
+
+	if (gen->segmentCount == 0)
+	{
+		if (gen->script != NULL)
+		{
+			Expand_Event(gen, &gen->script[gen->scriptInd]);
+			gen->scriptInd = (gen->scriptInd + 1) % gen->scriptLen;
+			gen->gestureCount++;
+		}
+		else if (gen->config.handInterval > 0)
+			Random_Gesture(gen);
+		else
+			Push_Segment(gen, gen->segmentEnd, UINT32_MAX, 0);
+	}
+
+	segment = &gen->segments[gen->segmentHead];
+	gen->segmentHead = (gen->segmentHead + 1) % SIMGEN_MAX_SEGMENTS;
+	gen->segmentCount--;
+
+	//	Land exactly on the previous target, covering the sensor is a jump
+	gen->position = gen->target;
+	if (segment->blocked) gen->position = segment->target;
+
+	gen->target = segment->target;
+	gen->step = (int32_t) (((int64_t) gen->target - gen->position) / (int64_t) segment->length);
+	gen->blocked = segment->blocked;
+	gen->handLeft = segment->length;
+
+	//	Restart noise at a random point, so the noise table period does not show
+	gen->cursor += Next_Random(gen);
+}
+
+/**
+ * @brief Switch sunlight on or off
+ *
+ * @param [out] gen
+ */
+static void Sun_Step(SimGen* gen)
+{
+	gen->sunny = !gen->sunny;
+	if (gen->sunny)
+	{
+		gen->level = Uniform(gen, gen->config.sunlight / 2, gen->config.sunlight);
+		gen->sunCount++;
+	}
+	else
+		gen->level = gen->config.ambient;
+
+	gen->sunLeft = Interval(gen, gen->config.sunInterval);
+}
+
+/**
+ * @brief Start or end an IR noise burst
+ *
+ * @param [out] gen
+ */
+static void Burst_Step(SimGen* gen)
+{
+	gen->burst = !gen->burst;
+	if (gen->burst)
+	{
+		gen->burstLeft = Samples(gen, gen->config.burstLength);
+		gen->burstCount++;
+	}
+	else
+		gen->burstLeft = Interval(gen, gen->config.burstInterval);
+}
+
+/**
+ * @brief Draw a new drift rate, towards no offset once the offset exceeds a minute of the largest rate
+ *
+ * @param [out] gen
+ */
+static void Drift_Step(SimGen* gen)
+{
+	int32_t rate = gen->config.driftRate;
+	int32_t limit = rate << SIMGEN_POSITION_BITS;
+
+	if (rate == 0)
+	{
+		gen->drift = 0;
+		gen->driftLeft = UINT32_MAX;
+		return;
+	}
+
+	rate = (int32_t) Uniform(gen, 0, 2 * rate) - rate;
+	if ((gen->offset > limit && rate > 0) || (gen->offset < -limit && rate < 0)) rate = -rate;
+
+	//	Counts per minute to 1/65536 counts per sample
+	gen->drift = (int32_t) (((int64_t) rate << SIMGEN_POSITION_BITS) * gen->config.samplePeriod / 60000000);
+	gen->driftLeft = Samples(gen, SIMGEN_DRIFT_MS);
+}
+
+/**
+ * @brief Fill samples of a still signal: a base value, drift and scaled noise
+ *
+ * @param [out] out
+ * @param [in] noise n noise values
+ * @param [in] n
+ * @param [in] base
+ * @param [in,out] offset drift offset (in 1/65536 counts)
+ * @param [in] drift drift offset change per sample (in 1/65536 counts)
+ * @param [in] amp noise standard deviation (in counts), at most #SIMGEN_MAX_NOISE
+ */
+static void Fill_Still(uint16_t* out, const int8_t* noise, uint32_t n, int32_t base, int32_t* offset, int32_t drift,
+	int32_t amp)
+{
+	int32_t value, off = *offset;
+	uint32_t k = 0;
+#ifdef __SSE2__
+	//	8 samples at a time: noise times amp fits 16 bits, the sum is clamped by a signed pack around 32768
+	__m128i zero = _mm_setzero_si128();
+	__m128i amp16 = _mm_set1_epi16((int16_t) amp);
+	__m128i base32 = _mm_set1_epi32(base - 32768);
+	__m128i bias = _mm_set1_epi16((int16_t) 0x8000);
+	__m128i offLo = _mm_setr_epi32(off, off + drift, off + 2 * drift, off + 3 * drift);
+	__m128i offHi = _mm_add_epi32(offLo, _mm_set1_epi32(4 * drift));
+	__m128i step = _mm_set1_epi32(8 * drift);
+
+	for (; k + 8 <= n; k += 8)
+	{
+		__m128i bytes = _mm_loadl_epi64((const __m128i *) &noise[k]);
+		__m128i words = _mm_unpacklo_epi8(bytes, _mm_cmpgt_epi8(zero, bytes));
+		__m128i scaled = _mm_srai_epi16(_mm_mullo_epi16(words, amp16), 4);
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(scaled, scaled), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(scaled, scaled), 16);
+
+		lo = _mm_add_epi32(_mm_add_epi32(lo, base32), _mm_srai_epi32(offLo, SIMGEN_POSITION_BITS));
+		hi = _mm_add_epi32(_mm_add_epi32(hi, base32), _mm_srai_epi32(offHi, SIMGEN_POSITION_BITS));
+		_mm_storeu_si128((__m128i *) &out[k], _mm_xor_si128(_mm_packs_epi32(lo, hi), bias));
+
+		offLo = _mm_add_epi32(offLo, step);
+		offHi = _mm_add_epi32(offHi, step);
+	}
+	off += (int32_t) k * drift;
+#endif
+
+	for (; k < n; k++)
+	{
+		value = base + (off >> SIMGEN_POSITION_BITS) + ((noise[k] * amp) >> 4);
+		out[k] = (value < 0) ? 0 : (value > UINT16_MAX) ? UINT16_MAX : value;
+		off += drift;
+	}
+
+	*offset = off;
+}
+
+/**
+ * @brief Generate samples with constant parameters
+ *
+ * @param [out] gen
+ * @param [out] ps
+ * @param [out] als
+ * @param [out] distance or NULL
+ * @param [in] n
+ */
+static void Fill_Run(SimGen* gen, uint16_t* ps, uint16_t* als, uint16_t* distance, uint32_t n)
+{
+	const uint16_t* curve = gen->curve;
+	int32_t position = gen->position, step = gen->step;
+	int32_t offset = gen->offset, drift = gen->drift, none = 0;
+	uint32_t cursor = gen->cursor;
+	int32_t level = gen->blocked ? 0 : gen->level;
+	int32_t psAmp = gen->burst ? gen->config.burstNoise : gen->config.psNoise;
+	int32_t alsAmp = gen->blocked ? 0 : gen->config.alsNoise;
+	int32_t ir = (level * (int32_t) gen->config.irCoupling) >> 10;
+	int32_t psVal;
+	uint32_t k, m;
+
+	while (n > 0)
+	{
+		//	Noise read straight on, the table repeats its first half
+		const int8_t* psNoise = &gen->noise[cursor % SIMGEN_NOISE_LEN];
+		const int8_t* alsNoise = &gen->noise[(cursor + SIMGEN_ALS_LAG) % SIMGEN_NOISE_LEN];
+		m = (n < SIMGEN_NOISE_LEN) ? n : SIMGEN_NOISE_LEN;
+
+		if (distance != NULL)
+		{
+			for (k = 0; k < m; k++)
+				distance[k] = (position + (int32_t) k * step) >> (SIMGEN_POSITION_BITS - SIMGEN_CURVE_BITS);
+			distance += m;
+		}
+
+		//	A still hand, most of the time, needs no curve lookup per sample
+		if (step == 0)
+			Fill_Still(ps, psNoise, m, ir + curve[position >> (SIMGEN_POSITION_BITS - SIMGEN_CURVE_BITS)], &offset, drift, psAmp);
+		else
+		{
+			for (k = 0; k < m; k++)
+			{
+				psVal = curve[position >> (SIMGEN_POSITION_BITS - SIMGEN_CURVE_BITS)] + ir +
+					(offset >> SIMGEN_POSITION_BITS) + ((psNoise[k] * psAmp) >> 4);
+				ps[k] = (psVal < 0) ? 0 : (psVal > UINT16_MAX) ? UINT16_MAX : psVal;
+				position += step;
+				offset += drift;
+			}
+		}
+
+		Fill_Still(als, alsNoise, m, level, &none, 0, alsAmp);
+
+		ps += m;
+		als += m;
+		n -= m;
+		cursor += m;
+	}
+
+	gen->position = position;
+	gen->offset = offset;
+	gen->cursor = cursor;
+}
+
+void SimGen_Default(SimGenConfig* config)
+{
+	config->seed = 1;
+	config->samplePeriod = 1000;
+	config->baseline = 650;
+	config->farDistance = 40;
+	config->psNoise = 3;
+	config->alsNoise = 2;
+	config->ambient = 200;
+	config->sunlight = 4000;
+	config->irCoupling = 4;
+	config->handInterval = 4000;
+	config->sunInterval = 20000;
+	config->burstInterval = 15000;
+	config->burstLength = 300;
+	config->burstNoise = 30;
+	config->driftRate = 5;
+}
+
+void Init_SimGen(SimGen* gen, const SimGenConfig* config, const uint16_t* proxTable)
+{
+	uint8_t last = DIST_LOOKUP_LEN - 1;
+	uint32_t j, i = 1;
+	double distance, ps;
+
+	gen->config = *config;
+	if (gen->config.samplePeriod == 0) gen->config.samplePeriod = 1;
+	if (gen->config.farDistance > SIMGEN_MAX_DISTANCE) gen->config.farDistance = SIMGEN_MAX_DISTANCE;
+	if (gen->config.farDistance <= distanceTable[last]) gen->config.farDistance = distanceTable[last] + 1;
+	if (gen->config.psNoise > SIMGEN_MAX_NOISE) gen->config.psNoise = SIMGEN_MAX_NOISE;
+	if (gen->config.alsNoise > SIMGEN_MAX_NOISE) gen->config.alsNoise = SIMGEN_MAX_NOISE;
+	if (gen->config.burstNoise > SIMGEN_MAX_NOISE) gen->config.burstNoise = SIMGEN_MAX_NOISE;
+	gen->random = config->seed ? config->seed : 1;
+
+	//	Distance_Lookup() inverted: table interpolation up to the last distance, then down to the baseline
+	for (j = 0; j < SIMGEN_CURVE_LEN; j++)
+	{
+		distance = (double) j / (1 << SIMGEN_CURVE_BITS);
+
+		if (distance <= distanceTable[last])
+		{
+			while (distance > distanceTable[i]) i++;
+			ps = proxTable[i - 1] + (distance - distanceTable[i - 1]) *
+				((double) proxTable[i] - proxTable[i - 1]) / ((double) distanceTable[i] - distanceTable[i - 1]);
+		}
+		else if (distance < gen->config.farDistance)
+			ps = proxTable[last] + (distance - distanceTable[last]) *
+				((double) gen->config.baseline - proxTable[last]) / ((double) gen->config.farDistance - distanceTable[last]);
+		else
+			ps = gen->config.baseline;
+
+		gen->curve[j] = (uint16_t) (ps + 0.5);
+	}
+
+	//	Sum of 4 uniform values in [-28, 28] halved, a standard deviation of ~16
+	for (j = 0; j < SIMGEN_NOISE_LEN; j++)
+	{
+		int32_t sum = 0;
+		for (i = 0; i < 4; i++) sum += (int32_t) (Next_Random(gen) % 57) - 28;
+		gen->noise[j] = (int8_t) (sum / 2);
+	}
+	for (j = 0; j < SIMGEN_NOISE_LEN; j++) gen->noise[SIMGEN_NOISE_LEN + j] = gen->noise[j];
+
+	gen->cursor = 0;
+	gen->script = NULL;
+	gen->scriptLen = 0;
+	gen->scriptInd = 0;
+	gen->segmentHead = 0;
+	gen->segmentCount = 0;
+	gen->segmentEnd = (int32_t) gen->config.farDistance << SIMGEN_POSITION_BITS;
+	gen->position = gen->segmentEnd;
+	gen->target = gen->segmentEnd;
+	gen->step = 0;
+	gen->blocked = 0;
+	gen->level = gen->config.ambient;
+	gen->sunny = 0;
+	gen->burst = 0;
+	gen->offset = 0;
+	gen->handLeft = 0;
+	gen->sunLeft = Interval(gen, gen->config.sunInterval);
+	gen->burstLeft = Interval(gen, gen->config.burstInterval);
+	gen->sampleCount = 0;
+	gen->gestureCount = 0;
+	gen->sunCount = 0;
+	gen->burstCount = 0;
+	Drift_Step(gen);
+}
+
+void SimGen_Script(SimGen* gen, const SimGenEvent* script, uint16_t len)
+{
+	gen->script = len ? script : NULL;
+	gen->scriptLen = len;
+	gen->scriptInd = 0;
+}
+
+void SimGen_Fill(SimGen* gen, uint16_t* ps, uint16_t* als, uint16_t* distance, uint32_t n)
+{
+	uint32_t run;
+
+	gen->sampleCount += n;
+
+	while (n > 0)
+	{
+		if (gen->handLeft == 0) Next_Segment(gen);
+		if (gen->sunLeft == 0) Sun_Step(gen);
+		if (gen->burstLeft == 0) Burst_Step(gen);
+		if (gen->driftLeft == 0) Drift_Step(gen);
+
+		//	Up to the next event on either side
+		run = n;
+		if (gen->handLeft < run) run = gen->handLeft;
+		if (gen->sunLeft < run) run = gen->sunLeft;
+		if (gen->burstLeft < run) run = gen->burstLeft;
+		if (gen->driftLeft < run) run = gen->driftLeft;
+
+		Fill_Run(gen, ps, als, distance, run);
+
+		gen->handLeft -= run;
+		gen->sunLeft -= run;
+		gen->burstLeft -= run;
+		gen->driftLeft -= run;
+		ps += run;
+		als += run;
+		if (distance != NULL) distance += run;
+		n -= run;
+	}
+}
+
+/**
+ * @brief Buffer index of the sample at a virtual time, generating up to it
+ *
+ * @param [out] gen
+ * @param [in] now (in us)
+ * @return buffer index
+ */
+static uint32_t Buffer_Seek(SimGen* gen, uint64_t now)
+{
+	uint64_t index = now / gen->config.samplePeriod;
+
+	//	The buffer holds the latest SIMGEN_BUFFER_LEN samples generated
+	while (index >= gen->sampleCount)
+		SimGen_Fill(gen, gen->bufferPS, gen->bufferALS, NULL, SIMGEN_BUFFER_LEN);
+
+	if (index + SIMGEN_BUFFER_LEN < gen->sampleCount) return 0;
+	return (uint32_t) (index + SIMGEN_BUFFER_LEN - gen->sampleCount);
+}
+
+uint16_t SimGen_PS(void* ctx, uint64_t now)
+{
+	SimGen* gen = (SimGen *) ctx;
+	return gen->bufferPS[Buffer_Seek(gen, now)];
+}
+
+uint16_t SimGen_ALS(void* ctx, uint64_t now)
+{
+	SimGen* gen = (SimGen *) ctx;
+	return gen->bufferALS[Buffer_Seek(gen, now)];
+}
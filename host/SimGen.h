@@ -0,0 +1,321 @@
+/**
+ * @file SimGen.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the synthetic PS/ALS workload generator, and related variables, methods
+ *
+ * Generates PS/ALS sample streams at a fixed sample period: hand approach and retreat, hovering, swipes and
+ * sensor blocking on the hand side, sunlight steps, IR noise bursts and slow PS drift on the ambient side.
+ * Hand gestures come from a script or are drawn at random; ambient events are always drawn at random from
+ * their mean intervals, an interval of 0 disables them.
+ *
+ * The PS response to the hand distance follows the proximity table and #distanceTable, inverted at
+ * Init_SimGen() into a curve with 64 points per distance unit, so Distance_Lookup() of a noise free sample
+ * returns the hand distance. Parameters only change at event boundaries: in between, a sample costs a
+ * curve and a noise table lookup, so generation runs at hundreds of millions of samples per second.
+ */
+
+#ifndef SIMGEN_H_
+#define SIMGEN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** @brief Curve points per distance unit, as a power of 2 */
+#define SIMGEN_CURVE_BITS 6
+
+/** @brief Largest distance, in #distanceTable units */
+#define SIMGEN_MAX_DISTANCE 64
+
+/** @brief Length of the PS curve */
+#define SIMGEN_CURVE_LEN ((SIMGEN_MAX_DISTANCE << SIMGEN_CURVE_BITS) + 1)
+
+/** @brief Length of the noise table, a power of 2 */
+#define SIMGEN_NOISE_LEN 4096
+
+/** @brief Largest noise standard deviation (in counts) */
+#define SIMGEN_MAX_NOISE 512
+
+/** @brief Number of pending hand segments */
+#define SIMGEN_MAX_SEGMENTS 16
+
+/** @brief Length of the buffer behind SimGen_PS() and SimGen_ALS() */
+#define SIMGEN_BUFFER_LEN 256
+
+/** @brief Distance in #distanceTable units as a SimGenEvent distance */
+#define SIMGEN_DISTANCE(d) ((uint16_t) ((d) * (1 << SIMGEN_CURVE_BITS)))
+
+/**
+ * @enum SimGenMotion_t
+ * @brief Hand gestures
+ */
+typedef enum SimGenMotion_t
+{
+	/** @brief Stay at the current distance */
+	SIMGEN_HOLD,
+
+	/** @brief Move to the event distance */
+	SIMGEN_APPROACH,
+
+	/** @brief Wobble around the current distance, by up to the event distance */
+	SIMGEN_HOVER,
+
+	/** @brief Move away to the far distance */
+	SIMGEN_RETREAT,
+
+	/** @brief Move to the event distance and back within the event duration */
+	SIMGEN_SWIPE,
+
+	/** @brief Cover the sensor, PS saturates and ALS is pinned to 0 */
+	SIMGEN_BLOCK
+} SimGenMotion;
+
+/**
+ * @struct SimGenEvent_t
+ * @brief Scripted hand gesture
+ */
+typedef struct SimGenEvent_t
+{
+	/** @brief Gesture */
+	SimGenMotion motion;
+
+	/** @brief Target or hover distance, see #SIMGEN_DISTANCE */
+	uint16_t distance;
+
+	/** @brief Gesture duration (in ms) */
+	uint32_t duration;
+} SimGenEvent;
+
+/**
+ * @struct SimGenConfig_t
+ * @brief Signal and event parameters
+ */
+typedef struct SimGenConfig_t
+{
+	/** @brief Random generator seed, must not be 0 */
+	uint32_t seed;
+
+	/** @brief Time between samples (in us) */
+	uint32_t samplePeriod;
+
+	/** @brief PS counts with no hand in front of the sensor */
+	uint16_t baseline;
+
+	/** @brief Distance of a retreated hand, where PS reaches the baseline (in #distanceTable units) */
+	uint16_t farDistance;
+
+	/** @brief PS noise standard deviation (in counts), at most #SIMGEN_MAX_NOISE */
+	uint16_t psNoise;
+
+	/** @brief ALS noise standard deviation (in counts), at most #SIMGEN_MAX_NOISE */
+	uint16_t alsNoise;
+
+	/** @brief Indoor ALS level (in counts) */
+	uint16_t ambient;
+
+	/** @brief Highest sunlight ALS level (in counts) */
+	uint16_t sunlight;
+
+	/** @brief PS counts added per 1024 ALS counts, the IR share of ambient light */
+	uint16_t irCoupling;
+
+	/** @brief Mean time between random hand gestures (in ms), 0 for none */
+	uint32_t handInterval;
+
+	/** @brief Mean time between sunlight steps (in ms), 0 for none */
+	uint32_t sunInterval;
+
+	/** @brief Mean time between IR noise bursts (in ms), 0 for none */
+	uint32_t burstInterval;
+
+	/** @brief IR noise burst duration (in ms) */
+	uint32_t burstLength;
+
+	/** @brief PS noise standard deviation during bursts (in counts), at most #SIMGEN_MAX_NOISE */
+	uint16_t burstNoise;
+
+	/** @brief Largest PS drift rate (in counts per minute), 0 for none */
+	uint16_t driftRate;
+} SimGenConfig;
+
+/**
+ * @struct SimGenSegment_t
+ * @brief Linear hand move
+ */
+typedef struct SimGenSegment_t
+{
+	/** @brief Distance at the end of the move (in 1/65536 distance units) */
+	int32_t target;
+
+	/** @brief Duration (in samples) */
+	uint32_t length;
+
+	/** @brief Sensor is covered */
+	uint8_t blocked;
+} SimGenSegment;
+
+/**
+ * @struct SimGen_t
+ * @brief Generator state
+ */
+typedef struct SimGen_t
+{
+	/** @brief Parameters */
+	SimGenConfig config;
+
+	/** @brief PS counts by distance, #SIMGEN_CURVE_BITS fractional bits */
+	uint16_t curve[SIMGEN_CURVE_LEN];
+
+	/** @brief Normal noise with a standard deviation of 16, twice over so runs read it without wrapping */
+	int8_t noise[2 * SIMGEN_NOISE_LEN];
+
+	/** @brief Random generator state */
+	uint32_t random;
+
+	/** @brief Noise table position */
+	uint32_t cursor;
+
+	/** @brief Scripted gestures, NULL for random ones */
+	const SimGenEvent* script;
+
+	/** @brief Number of scripted gestures */
+	uint16_t scriptLen;
+
+	/** @brief Next scripted gesture */
+	uint16_t scriptInd;
+
+	/** @brief Pending hand segments, a ring buffer */
+	SimGenSegment segments[SIMGEN_MAX_SEGMENTS];
+
+	/** @brief Index of the oldest pending segment */
+	uint8_t segmentHead;
+
+	/** @brief Number of pending segments */
+	uint8_t segmentCount;
+
+	/** @brief Distance at the end of the pending segments (in 1/65536 distance units) */
+	int32_t segmentEnd;
+
+	/** @brief Hand distance (in 1/65536 distance units) */
+	int32_t position;
+
+	/** @brief Hand distance at the end of the current segment (in 1/65536 distance units) */
+	int32_t target;
+
+	/** @brief Hand distance change per sample (in 1/65536 distance units) */
+	int32_t step;
+
+	/** @brief Sensor is covered */
+	uint8_t blocked;
+
+	/** @brief Ambient ALS level (in counts) */
+	uint16_t level;
+
+	/** @brief Sunlight is on */
+	uint8_t sunny;
+
+	/** @brief IR noise burst in progress */
+	uint8_t burst;
+
+	/** @brief PS drift offset (in 1/65536 counts) */
+	int32_t offset;
+
+	/** @brief PS drift offset change per sample (in 1/65536 counts) */
+	int32_t drift;
+
+	/** @brief Samples left in the current hand segment */
+	uint32_t handLeft;
+
+	/** @brief Samples to the next sunlight step */
+	uint32_t sunLeft;
+
+	/** @brief Samples to the next IR noise burst start or end */
+	uint32_t burstLeft;
+
+	/** @brief Samples to the next drift rate change */
+	uint32_t driftLeft;
+
+	/** @brief Samples generated */
+	uint64_t sampleCount;
+
+	/** @brief Hand gestures started */
+	uint32_t gestureCount;
+
+	/** @brief Sunlight steps */
+	uint32_t sunCount;
+
+	/** @brief IR noise bursts */
+	uint32_t burstCount;
+
+	/** @brief Latest PS samples, for SimGen_PS() */
+	uint16_t bufferPS[SIMGEN_BUFFER_LEN];
+
+	/** @brief Latest ALS samples, for SimGen_ALS() */
+	uint16_t bufferALS[SIMGEN_BUFFER_LEN];
+} SimGen;
+
+/**
+ * @brief Default parameters: indoor light, a gesture every 4 s, sunlight every 20 s, bursts every 15 s
+ *
+ * @param [out] config
+ */
+void SimGen_Default(SimGenConfig* config);
+
+/**
+ * @brief Initialise generator
+ *
+ * @param [out] gen
+ * @param [in] config
+ * @param [in] proxTable proximity table with respect to #distanceTable, falling PS with distance
+ */
+void Init_SimGen(SimGen* gen, const SimGenConfig* config, const uint16_t* proxTable);
+
+/**
+ * @brief Replace random hand gestures with a script, looped
+ *
+ * @param [out] gen
+ * @param [in] script gestures, must outlive the generator
+ * @param [in] len number of gestures, 0 restores random gestures
+ */
+void SimGen_Script(SimGen* gen, const SimGenEvent* script, uint16_t len);
+
+/**
+ * @brief Generate samples
+ *
+ * @param [out] gen
+ * @param [out] ps n PS values
+ * @param [out] als n ALS values
+ * @param [out] distance n true hand distances, see #SIMGEN_DISTANCE, or NULL
+ * @param [in] n number of samples
+ */
+void SimGen_Fill(SimGen* gen, uint16_t* ps, uint16_t* als, uint16_t* distance, uint32_t n);
+
+/**
+ * @brief Generated PS value, a SimSignal
+ *
+ * Samples are generated in blocks up to the sample at a virtual time, which must not go back; a generator
+ * serving as SimSignal is not to be used with SimGen_Fill() as well.
+ *
+ * @param [in] ctx SimGen
+ * @param [in] now (in us)
+ * @return PS counts
+ */
+uint16_t SimGen_PS(void* ctx, uint64_t now);
+
+/**
+ * @brief Generated ALS value, a SimSignal
+ *
+ * @param [in] ctx SimGen
+ * @param [in] now (in us)
+ * @return ALS counts
+ */
+uint16_t SimGen_ALS(void* ctx, uint64_t now);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SIMGEN_H_ */
@@ -0,0 +1,163 @@
+/**
+ * @file SimI2C.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for the simulated I2C bus, VCNL devices and mux, and related variables, methods
+ *
+ * The simulated bus holds a set of VCNLXXXX register models, optionally behind a TCA9548 style mux, and
+ * charges every transaction its byte time on the virtual clock. A PS force trigger starts a conversion that
+ * completes after the device conversion time; reading CMD_PS1_DATA before then returns the previous result
+ * and is counted as a stale read. PS and ALS values come from per-device signal callbacks.
+ */
+
+
+#include <string.h>
+#include <stddef.h>
+#include "SimI2C.h"
+#include "SimClock.h"
+
+#define SIM_CMD_PS_CONF3_MS 0x04
+#define SIM_CMD_PS1_DATA 0x08
+#define SIM_CMD_ALS_DATA 0x0B
+#define SIM_CMD_DEVICE_ID 0x0E
+#define SIM_PS_TRIG 0x04
+#define SIM_PS_AF 0x08
+
+SimBus simBus;
+
+/**
+ * @brief Charge bus time for a transaction of a number of bytes
+ *
+ * @param [in] bytes
+ */
+static void SimBus_Transfer(uint8_t bytes)
+{
+	uint64_t time = (uint64_t) bytes * simBus.byteTime;
+
+	simBus.transactionCount++;
+	simBus.busyTime += time;
+	Sim_Advance(time);
+}
+
+/**
+ * @brief Find device answering an address with the current mux selection
+ *
+ * @param [in] address
+ * @return device, or NULL if none answers
+ */
+static SimVcnl* SimBus_Find(uint8_t address)
+{
+	uint8_t i;
+	SimVcnl* device;
+
+	for (i = 0; i < simBus.deviceCount; i++)
+	{
+		device = &simBus.devices[i];
+		if (device->address != address) continue;
+		if ((device->muxChannel == SIM_NO_MUX) || (simBus.muxMask & (1 << device->muxChannel))) return device;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Latch result of a finished conversion into CMD_PS1_DATA
+ *
+ * @param [out] device
+ */
+static void SimVcnl_Settle(SimVcnl* device)
+{
+	if (device->converting && (Sim_Now() >= device->conversionEnd))
+	{
+		device->regs[SIM_CMD_PS1_DATA] = device->ps ? device->ps(device->ctx, device->conversionEnd) : 0;
+		device->converting = 0;
+	}
+}
+
+void Init_SimBus(uint8_t muxAddress, uint32_t byteTime)
+{
+	memset(&simBus, 0, sizeof(SimBus));
+	simBus.muxAddress = muxAddress;
+	simBus.byteTime = byteTime;
+}
+
+SimVcnl* SimBus_Add(uint8_t address, uint8_t muxChannel, uint32_t conversionTime, SimSignal ps, SimSignal als, void* ctx)
+{
+	SimVcnl* device;
+
+	if (simBus.deviceCount >= SIM_MAX_DEVICES) return NULL;
+
+	device = &simBus.devices[simBus.deviceCount++];
+	memset(device, 0, sizeof(SimVcnl));
+	device->address = address;
+	device->muxChannel = muxChannel;
+	device->conversionTime = conversionTime;
+	device->ps = ps;
+	device->als = als;
+	device->ctx = ctx;
+	device->regs[SIM_CMD_DEVICE_ID] = 0x0080;
+
+	return device;
+}
+
+uint8_t SimI2C_Write(uint8_t address, uint8_t cmd, uint8_t lsb, uint8_t msb)
+{
+	SimVcnl* device;
+
+	// Address, command, LSB, MSB
+	SimBus_Transfer(4);
+
+	device = SimBus_Find(address);
+	if ((device == NULL) || (cmd >= 16)) return SIM_NACK_ADDR;
+
+	SimVcnl_Settle(device);
+	device->writeCount++;
+
+	if ((cmd == SIM_CMD_PS_CONF3_MS) && (lsb & SIM_PS_TRIG))
+	{
+		// Force trigger only starts a conversion in active force mode, trigger bit self clears
+		if (lsb & SIM_PS_AF)
+		{
+			device->converting = 1;
+			device->conversionEnd = Sim_Now() + device->conversionTime;
+			device->triggerCount++;
+		}
+		lsb &= ~SIM_PS_TRIG;
+	}
+
+	device->regs[cmd] = ((uint16_t) msb << 8) | lsb;
+	return 0;
+}
+
+uint8_t SimI2C_Read(uint8_t address, uint8_t cmd, uint16_t* value)
+{
+	SimVcnl* device;
+
+	// Address, command, repeated start address, LSB, MSB
+	SimBus_Transfer(5);
+
+	device = SimBus_Find(address);
+	if ((device == NULL) || (cmd >= 16)) return SIM_NACK_ADDR;
+
+	SimVcnl_Settle(device);
+
+	if (cmd == SIM_CMD_PS1_DATA && device->converting)
+		device->staleCount++;
+
+	if (cmd == SIM_CMD_ALS_DATA)
+		device->regs[cmd] = device->als ? device->als(device->ctx, Sim_Now()) : 0;
+
+	*value = device->regs[cmd];
+	return 0;
+}
+
+uint8_t SimI2C_Select(uint8_t muxAddress, uint8_t mask)
+{
+	// Address, channel mask
+	SimBus_Transfer(2);
+
+	if (muxAddress != simBus.muxAddress) return SIM_NACK_ADDR;
+
+	simBus.muxMask = mask;
+	return 0;
+}
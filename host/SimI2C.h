@@ -0,0 +1,170 @@
+/**
+ * @file SimI2C.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the simulated I2C bus, VCNL devices and mux, and related variables, methods
+ *
+ * The simulated bus holds a set of VCNLXXXX register models, optionally behind a TCA9548 style mux, and
+ * charges every transaction its byte time on the virtual clock. A PS force trigger starts a conversion that
+ * completes after the device conversion time; reading CMD_PS1_DATA before then returns the previous result
+ * and is counted as a stale read. PS and ALS values come from per-device signal callbacks.
+ */
+
+#ifndef SIMI2C_H_
+#define SIMI2C_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** @brief Maximum number of simulated devices */
+#ifndef SIM_MAX_DEVICES
+#define SIM_MAX_DEVICES 16
+#endif
+
+/** @brief Mux channel of a device attached directly to the bus */
+#define SIM_NO_MUX 0xFF
+
+/** @brief Transaction status for an address nobody acknowledged, as Wire.endTransmission() */
+#define SIM_NACK_ADDR 2
+
+/** @brief Default byte time at 400 kHz, 9 clocks per byte (in us) */
+#define SIM_BYTE_TIME_US 23
+
+/**
+ * @brief Signal source, value of a channel at a virtual time
+ */
+typedef uint16_t (*SimSignal)(void* ctx, uint64_t now);
+
+/**
+ * @struct SimVcnl_t
+ * @brief Simulated VCNL register model
+ */
+typedef struct SimVcnl_t
+{
+	/** @brief I2C address */
+	uint8_t address;
+
+	/** @brief Mux channel, #SIM_NO_MUX if attached directly */
+	uint8_t muxChannel;
+
+	/** @brief Command registers, MSB in the upper byte */
+	uint16_t regs[16];
+
+	/** @brief PS conversion time after a force trigger (in us) */
+	uint32_t conversionTime;
+
+	/** @brief Completion time of the conversion in flight (in us) */
+	uint64_t conversionEnd;
+
+	/** @brief Flag for a conversion in flight */
+	uint8_t converting;
+
+	/** @brief PS signal source */
+	SimSignal ps;
+
+	/** @brief ALS signal source */
+	SimSignal als;
+
+	/** @brief Context passed to the signal sources */
+	void* ctx;
+
+	/** @brief Number of force triggers */
+	uint32_t triggerCount;
+
+	/** @brief Number of PS reads returning a result older than the latest trigger */
+	uint32_t staleCount;
+
+	/** @brief Number of register writes */
+	uint32_t writeCount;
+} SimVcnl;
+
+/**
+ * @struct SimBus_t
+ * @brief Simulated bus with its devices and mux
+ */
+typedef struct SimBus_t
+{
+	/** @brief Devices on the bus */
+	SimVcnl devices[SIM_MAX_DEVICES];
+
+	/** @brief Number of devices */
+	uint8_t deviceCount;
+
+	/** @brief Mux I2C address */
+	uint8_t muxAddress;
+
+	/** @brief Mux channel mask */
+	uint8_t muxMask;
+
+	/** @brief Time per transferred byte including address byte (in us) */
+	uint32_t byteTime;
+
+	/** @brief Number of transactions */
+	uint32_t transactionCount;
+
+	/** @brief Total virtual time the bus was held (in us) */
+	uint64_t busyTime;
+} SimBus;
+
+/** @brief Simulated bus used by the bus functions below */
+extern SimBus simBus;
+
+/**
+ * @brief Reset simulated bus to no devices
+ *
+ * @param [in] muxAddress
+ * @param [in] byteTime (in us)
+ */
+void Init_SimBus(uint8_t muxAddress, uint32_t byteTime);
+
+/**
+ * @brief Attach simulated VCNL to bus
+ *
+ * @param [in] address
+ * @param [in] muxChannel #SIM_NO_MUX if attached directly
+ * @param [in] conversionTime (in us)
+ * @param [in] ps
+ * @param [in] als
+ * @param [in] ctx
+ * @return device, or NULL if the bus is full
+ */
+SimVcnl* SimBus_Add(uint8_t address, uint8_t muxChannel, uint32_t conversionTime, SimSignal ps, SimSignal als, void* ctx);
+
+/**
+ * @brief Write one command register
+ *
+ * @param [in] address
+ * @param [in] cmd
+ * @param [in] lsb
+ * @param [in] msb
+ * @return 0 on success, #SIM_NACK_ADDR if no device answered
+ */
+uint8_t SimI2C_Write(uint8_t address, uint8_t cmd, uint8_t lsb, uint8_t msb);
+
+/**
+ * @brief Read one command register
+ *
+ * @param [in] address
+ * @param [in] cmd
+ * @param [out] value
+ * @return 0 on success, #SIM_NACK_ADDR if no device answered
+ */
+uint8_t SimI2C_Read(uint8_t address, uint8_t cmd, uint16_t* value);
+
+/**
+ * @brief Write mux channel mask
+ *
+ * @param [in] muxAddress
+ * @param [in] mask
+ * @return 0 on success, #SIM_NACK_ADDR if the mux did not answer
+ */
+uint8_t SimI2C_Select(uint8_t muxAddress, uint8_t mask);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SIMI2C_H_ */
@@ -0,0 +1,108 @@
+/**
+ * @file SimTrace.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Source file for recorded PS/ALS traces as simulated sensor signals, and related variables, methods
+ *
+ * A trace is loaded once from time_ms,ps,als lines, as printed by fr_decode, and shared read-only; each
+ * replay loops over it from its own time offset and serves as SimSignal of a simulated VCNL. Labeled traces,
+ * e.g. from bench_gen, carry the true hand distance as a fourth column for scoring and calibration.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "SimTrace.h"
+
+int SimTrace_Load(SimTrace* trace, const char* path)
+{
+	FILE* file = fopen(path, "r");
+	char line[128];
+	unsigned time, ps, als;
+	float distance = 0;
+	uint32_t capacity = 0;
+	uint8_t labeled = 1;
+	int fields;
+
+	if (file == NULL) return -1;
+
+	trace->time = NULL;
+	trace->ps = NULL;
+	trace->als = NULL;
+	trace->distance = NULL;
+	trace->length = 0;
+
+	//	Lines other than time_ms,ps,als[,distance], e.g. the header, are skipped
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		fields = sscanf(line, "%u,%u,%u,%f", &time, &ps, &als, &distance);
+		if (fields < 3) continue;
+
+		if (trace->length == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 1024;
+			trace->time = realloc(trace->time, capacity * sizeof(uint32_t));
+			trace->ps = realloc(trace->ps, capacity * sizeof(uint16_t));
+			trace->als = realloc(trace->als, capacity * sizeof(uint16_t));
+			trace->distance = realloc(trace->distance, capacity * sizeof(float));
+		}
+
+		trace->time[trace->length] = time;
+		trace->ps[trace->length] = ps;
+		trace->als[trace->length] = als;
+		trace->distance[trace->length] = distance;
+		trace->length++;
+
+		//	Labels only count if every sample has one
+		if (fields != 4) labeled = 0;
+	}
+	fclose(file);
+
+	if (!labeled)
+	{
+		free(trace->distance);
+		trace->distance = NULL;
+	}
+
+	if (trace->length == 0) return -1;
+
+	//	Times from the first sample, the trace loops one sample period after its last sample
+	for (time = trace->length; time-- > 0;)
+		trace->time[time] -= trace->time[0];
+
+	trace->duration = trace->time[trace->length - 1] + 1;
+	if (trace->length > 1)
+		trace->duration += trace->time[trace->length - 1] - trace->time[trace->length - 2] - 1;
+
+	return 0;
+}
+
+/**
+ * @brief Index of the trace sample at a virtual time
+ *
+ * @param [out] replay
+ * @param [in] now (in us)
+ * @return sample index
+ */
+static uint32_t Replay_Seek(SimReplay* replay, uint64_t now)
+{
+	const SimTrace* trace = replay->trace;
+	uint32_t time = (uint32_t) ((now / 1000 + replay->offset) % trace->duration);
+
+	if (trace->time[replay->cursor] > time) replay->cursor = 0;
+	while ((replay->cursor + 1 < trace->length) && (trace->time[replay->cursor + 1] <= time))
+		replay->cursor++;
+
+	return replay->cursor;
+}
+
+uint16_t SimReplay_PS(void* ctx, uint64_t now)
+{
+	SimReplay* replay = (SimReplay *) ctx;
+	return replay->trace->ps[Replay_Seek(replay, now)];
+}
+
+uint16_t SimReplay_ALS(void* ctx, uint64_t now)
+{
+	SimReplay* replay = (SimReplay *) ctx;
+	return replay->trace->als[Replay_Seek(replay, now)];
+}
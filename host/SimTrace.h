@@ -0,0 +1,93 @@
+/**
+ * @file SimTrace.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for recorded PS/ALS traces as simulated sensor signals, and related variables, methods
+ *
+ * A trace is loaded once from time_ms,ps,als lines, as printed by fr_decode, and shared read-only; each
+ * replay loops over it from its own time offset and serves as SimSignal of a simulated VCNL. Labeled traces,
+ * e.g. from bench_gen, carry the true hand distance as a fourth column for scoring and calibration.
+ */
+
+#ifndef SIMTRACE_H_
+#define SIMTRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @struct SimTrace_t
+ * @brief Recorded PS/ALS trace, as printed by fr_decode
+ */
+typedef struct SimTrace_t
+{
+	/** @brief Sample times from the first sample (in ms) */
+	uint32_t* time;
+
+	/** @brief PS values */
+	uint16_t* ps;
+
+	/** @brief ALS values */
+	uint16_t* als;
+
+	/** @brief True hand distances (in #distanceTable units), NULL unless every line is labeled */
+	float* distance;
+
+	/** @brief Number of samples */
+	uint32_t length;
+
+	/** @brief Trace duration, one sample period past the last sample (in ms) */
+	uint32_t duration;
+} SimTrace;
+
+/**
+ * @struct SimReplay_t
+ * @brief Looping replay of a shared trace from a time offset
+ */
+typedef struct SimReplay_t
+{
+	/** @brief Trace, shared read-only between replays */
+	const SimTrace* trace;
+
+	/** @brief Trace time at virtual time 0 (in ms) */
+	uint32_t offset;
+
+	/** @brief Index of the latest sample returned */
+	uint32_t cursor;
+} SimReplay;
+
+/**
+ * @brief Load a time_ms,ps,als trace, or a time_ms,ps,als,distance labeled trace
+ *
+ * @param [out] trace
+ * @param [in] path
+ * @return 0 on success, -1 if the file could not be read or holds no samples
+ */
+int SimTrace_Load(SimTrace* trace, const char* path);
+
+/**
+ * @brief Replayed PS value, a SimSignal
+ *
+ * @param [in] ctx SimReplay
+ * @param [in] now (in us)
+ * @return PS counts
+ */
+uint16_t SimReplay_PS(void* ctx, uint64_t now);
+
+/**
+ * @brief Replayed ALS value, a SimSignal
+ *
+ * @param [in] ctx SimReplay
+ * @param [in] now (in us)
+ * @return ALS counts
+ */
+uint16_t SimReplay_ALS(void* ctx, uint64_t now);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* SIMTRACE_H_ */
@@ -0,0 +1,216 @@
+/**
+ * @file bench_baseline.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Proximity detection under slow PS crosstalk drift, with fixed and baseline tracked thresholds
+ *
+ * Usage: bench_baseline [-d drift] [-b decimation] [-s seconds]
+ *
+ * Generates -s seconds (default 1800) of 100 Hz samples with bench_gen's generator and random gestures, and
+ * adds a slow crosstalk drift: one period of a sine of -d counts (default 80) over the run, so PS rises
+ * first and ends below where it started. The controller's hysteresis runs on the fast window, as in the
+ * sketch, with fixed thresholds and with a SensorBaseline of -b sample blocks (default 256).
+ *
+ * A hand within PRESENCE_DISTANCE is an episode, missed if the sensor never enters proximity during it;
+ * stuck is the share of samples with no hand within FAR_DISTANCE spent in proximity. Cost is the TSC
+ * cycles of one Update_Sensor_PS() call, on x86.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "Sensor.h"
+#include "SimGen.h"
+
+#define PERIOD_US 10000
+#define SECONDS 1800
+#define DRIFT 80
+#define DECIMATION 256
+#define PS_MIN_HYST 680
+#define PS_MAX_HYST 700
+#define PRESENCE_DISTANCE 20
+#define FAR_DISTANCE 28
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+/**
+ * @struct Result_t
+ * @brief Scores of one threshold configuration
+ */
+typedef struct Result_t
+{
+	/** @brief Hand episodes */
+	uint32_t episodes;
+
+	/** @brief Episodes never detected */
+	uint32_t misses;
+
+	/** @brief Proximity entries */
+	uint32_t entries;
+
+	/** @brief Share of samples without a hand spent in proximity */
+	double stuck;
+
+	/** @brief Largest \ref Sensor.psOffset */
+	int16_t maxOffset;
+
+	/** @brief Smallest \ref Sensor.psOffset */
+	int16_t minOffset;
+
+	/** @brief TSC cycles per Update_Sensor_PS(), 0 if not on x86 */
+	double cycles;
+} Result;
+
+static uint64_t Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Generate labeled samples with a sine drift added
+ */
+static void Generate(const SimGenConfig* config, uint16_t* ps, float* distance, uint32_t n, uint16_t drift)
+{
+	static SimGen gen;
+	static uint16_t als[4096], label[4096];
+	uint32_t i, j, k;
+	double value;
+
+	Init_SimGen(&gen, config, proximityTable);
+	for (i = 0; i < n; i += k)
+	{
+		k = (n - i < 4096) ? n - i : 4096;
+		SimGen_Fill(&gen, &ps[i], als, label, k);
+		for (j = 0; j < k; j++)
+		{
+			value = ps[i + j] + drift * sin(2 * M_PI * (i + j) / n);
+			ps[i + j] = (value < 0) ? 0 : (value > UINT16_MAX) ? UINT16_MAX : (uint16_t) (value + 0.5);
+			distance[i + j] = (float) label[j] / SIMGEN_DISTANCE(1);
+		}
+	}
+}
+
+static void Score(Result* result, SensorBaseline* baseline, const uint16_t* ps, const float* truth, uint32_t n)
+{
+	static Sensor sensor;
+	uint32_t k, far = 0, farIn = 0;
+	uint8_t wasInProximity, inEpisode = 0, hit = 0;
+	uint64_t cycles = 0, start;
+
+	Init_Sensor(&sensor, 0, PS_MIN_HYST, PS_MAX_HYST, proximityTable);
+	sensor.psFilter = SENSOR_FILTER_FAST;
+	if (baseline != NULL) Set_PS_Baseline(&sensor, baseline);
+
+	result->episodes = 0;
+	result->misses = 0;
+	result->entries = 0;
+	result->maxOffset = 0;
+	result->minOffset = 0;
+
+	for (k = 0; k < n; k++)
+	{
+		wasInProximity = sensor.inProximity;
+
+		start = Cycles();
+		Update_Sensor_PS(&sensor, ps[k]);
+		cycles += Cycles() - start;
+
+		if (!wasInProximity && sensor.inProximity) result->entries++;
+		if (sensor.psOffset > result->maxOffset) result->maxOffset = sensor.psOffset;
+		if (sensor.psOffset < result->minOffset) result->minOffset = sensor.psOffset;
+
+		if (truth[k] <= PRESENCE_DISTANCE)
+		{
+			if (!inEpisode)
+			{
+				inEpisode = 1;
+				hit = 0;
+				result->episodes++;
+			}
+			hit |= sensor.inProximity;
+		}
+		else if (inEpisode)
+		{
+			inEpisode = 0;
+			if (!hit) result->misses++;
+		}
+
+		if (truth[k] > FAR_DISTANCE)
+		{
+			far++;
+			farIn += sensor.inProximity;
+		}
+	}
+
+	if (inEpisode && !hit) result->misses++;
+	result->stuck = far ? (double) farIn / far : 0;
+	result->cycles = (double) cycles / n;
+}
+
+static void Print(const char* name, const Result* r)
+{
+	printf("%-9s %8u %6u %7u %7.1f%% %6d %6d %7.0f\n", name, r->episodes, r->misses, r->entries, 100 * r->stuck,
+		r->minOffset, r->maxOffset, r->cycles);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t seconds = SECONDS, decimation = DECIMATION, drift = DRIFT, n;
+	SimGenConfig config;
+	SensorBaseline baseline;
+	Result fixed, tracked;
+	uint16_t* ps;
+	float* truth;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "d:b:s:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'd':
+				drift = atoi(optarg);
+				break;
+			case 'b':
+				decimation = atoi(optarg);
+				break;
+			case 's':
+				seconds = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-d drift] [-b decimation] [-s seconds]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	SimGen_Default(&config);
+	config.samplePeriod = PERIOD_US;
+	n = seconds * (1000000 / PERIOD_US);
+
+	ps = malloc(n * sizeof(uint16_t));
+	truth = malloc(n * sizeof(float));
+	Generate(&config, ps, truth, n, drift);
+
+	Score(&fixed, NULL, ps, truth, n);
+	Init_Sensor_Baseline(&baseline, 0, decimation);
+	Score(&tracked, &baseline, ps, truth, n);
+
+	printf("%u Hz, %u s of random gestures, drift %u counts, blocks of %u samples\n", 1000000 / PERIOD_US,
+		seconds, drift, decimation);
+	printf("threshold episodes misses entries   stuck  minOff maxOff  cycles\n");
+	Print("fixed", &fixed);
+	Print("baseline", &tracked);
+
+	free(ps);
+	free(truth);
+	return 0;
+}
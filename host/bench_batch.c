@@ -0,0 +1,140 @@
+/**
+ * @file bench_batch.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Benchmark of Update_Sensor_Batch against one Update_Sensor call per sample
+ *
+ * Usage: bench_batch [samples] [batch]
+ *
+ * Feeds the same noisy PS/ALS signal with periodic hand approaches to two sensors, one sample at a time and
+ * in batches, compares the derived fields after every batch and the number of proximity entries, and
+ * reports time per sample for both. The derived fields are compared again with distance Kalman filters, and
+ * after a batch in which a covered sensor is uncovered, leaves proximity and enters it again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Sensor.h"
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+static double Elapsed_Ns(const struct timespec* start, const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+#define COVERED_LEN 40
+#define UNCOVER_LEN 8
+
+static int Same_State(const Sensor* a, const Sensor* b)
+{
+	return a->sampleCount == b->sampleCount && a->alsSampleCount == b->alsSampleCount &&
+		a->psMean == b->psMean && a->psSTD == b->psSTD && a->alsMean == b->alsMean && a->alsSTD == b->alsSTD &&
+		a->estimatedDistance == b->estimatedDistance && a->estimatedVelocity == b->estimatedVelocity &&
+		a->predictedDistance == b->predictedDistance && a->inProximity == b->inProximity &&
+		a->isBlocked == b->isBlocked && a->psWindowSum == b->psWindowSum && a->alsWindowSum == b->alsWindowSum &&
+		a->psMin == b->psMin && a->psMax == b->psMax && a->alsMin == b->alsMin && a->alsMax == b->alsMax;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t i, j, k, n = (argc > 1) ? atoi(argv[1]) : 2000000;
+	uint16_t batch = (argc > 2) ? atoi(argv[2]) : 8;
+	uint16_t* ps = malloc(n * sizeof(uint16_t));
+	uint16_t* als = malloc(n * sizeof(uint16_t));
+	static Sensor single, batched;
+	static SensorKalman singleKalman, batchedKalman;
+	struct timespec start, end;
+	double singleNs, batchNs;
+	uint32_t singleEntries = 0, batchEntries = 0, mismatches = 0;
+	uint8_t wasInProximity;
+
+	if (batch == 0) batch = 1;
+
+	//	Baseline with small noise, a 1 s hand approach every 5 s at 100 Hz, short spikes through the thresholds
+	srand(1);
+	for (i = 0; i < n; i++)
+	{
+		uint32_t phase = i % 500;
+		ps[i] = 650 + rand() % 9 + ((phase < 100) ? (uint16_t) (phase * phase) : 0);
+		if (phase == 250 || phase == 253) ps[i] = 900;
+		als[i] = 200 + rand() % 5;
+	}
+
+	//	One Update_Sensor call per sample
+	Init_Sensor(&single, 0, 680, 700, proximityTable);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < n; i++)
+	{
+		wasInProximity = single.inProximity;
+		Update_Sensor(&single, ps[i], als[i]);
+		if (!wasInProximity && single.inProximity) singleEntries++;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	singleNs = Elapsed_Ns(&start, &end);
+
+	//	Batches of the same samples
+	Init_Sensor(&batched, 0, 680, 700, proximityTable);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < n; i += batch)
+	{
+		j = (n - i < batch) ? n - i : batch;
+		batchEntries += Update_Sensor_Batch(&batched, &ps[i], &als[i], j);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	batchNs = Elapsed_Ns(&start, &end);
+
+	//	Derived fields after every batch, against the per-sample sensor
+	Init_Sensor(&single, 0, 680, 700, proximityTable);
+	Init_Sensor(&batched, 0, 680, 700, proximityTable);
+	for (i = 0; i < n; i += batch)
+	{
+		j = (n - i < batch) ? n - i : batch;
+		Update_Sensor_Batch(&batched, &ps[i], &als[i], j);
+		for (k = i; k < i + j; k++) Update_Sensor(&single, ps[k], als[k]);
+		if (!Same_State(&single, &batched)) mismatches++;
+	}
+
+	//	Again with distance filters, which take every raw sample
+	Init_Sensor(&single, 0, 680, 700, proximityTable);
+	Init_Sensor(&batched, 0, 680, 700, proximityTable);
+	Init_Sensor_Kalman(&singleKalman, 3, 2000, 10000);
+	Init_Sensor_Kalman(&batchedKalman, 3, 2000, 10000);
+	Set_Distance_Kalman(&single, &singleKalman);
+	Set_Distance_Kalman(&batched, &batchedKalman);
+	for (i = 0; i < n; i += batch)
+	{
+		j = (n - i < batch) ? n - i : batch;
+		Update_Sensor_Batch(&batched, &ps[i], &als[i], j);
+		for (k = i; k < i + j; k++) Update_Sensor(&single, ps[k], als[k]);
+		if (!Same_State(&single, &batched)) mismatches++;
+	}
+
+	//	Covered until blocked, then one batch uncovering it with an exit and entry, which must clear the flag
+	Init_Sensor(&single, 0, 680, 700, proximityTable);
+	Init_Sensor(&batched, 0, 680, 700, proximityTable);
+	for (i = 0; i < COVERED_LEN + UNCOVER_LEN; i++)
+	{
+		ps[i] = (i == COVERED_LEN + 1 || i == COVERED_LEN + 2) ? 600 : 1000;
+		als[i] = (i < COVERED_LEN) ? 0 : 200;
+		if (i < COVERED_LEN) Update_Sensor_Batch(&batched, &ps[i], &als[i], 1);
+	}
+	for (i = 0; i < COVERED_LEN + UNCOVER_LEN; i++) Update_Sensor(&single, ps[i], als[i]);
+	Update_Sensor_Batch(&batched, &ps[COVERED_LEN], &als[COVERED_LEN], UNCOVER_LEN);
+	if (!Same_State(&single, &batched)) mismatches++;
+
+	printf("batch: %u\n", batch);
+	printf("ns per sample, single: %.1f\n", singleNs / n);
+	printf("ns per sample, batch: %.1f\n", batchNs / n);
+	printf("speedup: %.2fx\n", singleNs / batchNs);
+	printf("proximity entries, single: %u batch: %u\n", singleEntries, batchEntries);
+	printf("blocked after uncovering, single: %u batch: %u\n", single.isBlocked, batched.isBlocked);
+	printf("state mismatches: %u\n", mismatches);
+
+	free(ps);
+	free(als);
+	return (mismatches == 0 && singleEntries == batchEntries) ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file bench_dual.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Proximity entry latency and intensity smoothness of single and dual PS windows on labeled traces
+ *
+ * Usage: bench_dual [-f fast_window] [-w window] [-d distance] [-g grace_ms] trace...
+ *
+ * Traces are time_ms,ps,als,distance lines, e.g. from bench_gen. Each is replayed through
+ * Update_Sensor_PS() with the controller's hysteresis on the raw value, on the mean of a -w sample window
+ * (default PS_WINDOW), on the mean of a -f sample window (default PS_FAST_WINDOW) alone, and on the -f
+ * sample fast window with the -w sample window kept for the distance. As in sweep, a hand within -d
+ * distance units (default 20) is an episode; the first entry from grace_ms (default 200) before to
+ * grace_ms after it detects it, every other entry is a false toggle.
+ *
+ * Reported per configuration are entries, false toggles, misses, the mean entry latency, and the RMS
+ * change of the lamp brightness from one sample to the next while in proximity, from predictedDistance
+ * as processBatch() uses it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include "Sensor.h"
+#include "SimTrace.h"
+
+#define PS_MIN_HYST 680
+#define PS_MAX_HYST 700
+#define PRESENCE_DISTANCE 20
+#define GRACE_MS 200
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+/**
+ * @struct DualConfig_t
+ * @brief Replayed configuration and its scores
+ */
+typedef struct DualConfig_t
+{
+	const char* name;
+	uint8_t filter;
+	uint8_t window;
+	uint8_t fastWindow;
+
+	uint32_t entries;
+	uint32_t falseToggles;
+	uint32_t misses;
+	uint32_t detected;
+	uint64_t latencySum;
+	double jitterSum;
+	uint32_t jitterCount;
+} DualConfig;
+
+/**
+ * @brief Lamp brightness of a distance, as processBatch() computes intensity
+ */
+static double Brightness(double distance)
+{
+	double intensity = (distance < 5) ? 5 : distance;
+
+	intensity = tan((intensity - 5) / 20 * 0.8);
+	if (intensity < 0.008) intensity = 0.008;
+	return (intensity > 1) ? 1 : intensity;
+}
+
+static void Replay(DualConfig* config, const SimTrace* trace, float presence, uint32_t grace)
+{
+	static Sensor sensor;
+	uint32_t k, start = 0, end = 0, next = 0;
+	uint8_t wasInProximity, inEpisode = 0, hit = 0;
+	double brightness, previous = 0;
+
+	Init_Sensor(&sensor, 0, PS_MIN_HYST, PS_MAX_HYST, proximityTable);
+	Set_PS_Window(&sensor, config->window);
+	Set_PS_Fast_Window(&sensor, config->fastWindow);
+	sensor.psFilter = config->filter;
+
+	for (k = 0; k < trace->length; k++)
+	{
+		//	Episode around sample k: from the first sample within presence to the last, plus the grace time
+		if (!inEpisode && k >= next)
+		{
+			for (start = k; start < trace->length && trace->distance[start] > presence; start++);
+			for (end = start; end + 1 < trace->length && trace->distance[end + 1] <= presence; end++);
+			next = end + 1;
+			inEpisode = (start < trace->length);
+			hit = 0;
+		}
+
+		if (inEpisode && k > end && trace->time[k] - trace->time[end] > grace)
+		{
+			if (!hit) config->misses++;
+			inEpisode = 0;
+			k--;
+			continue;
+		}
+
+		wasInProximity = sensor.inProximity;
+		Update_Sensor_PS(&sensor, trace->ps[k]);
+
+		if (!wasInProximity && sensor.inProximity)
+		{
+			config->entries++;
+			if (inEpisode && !hit && trace->time[k] + grace >= trace->time[start])
+			{
+				hit = 1;
+				config->detected++;
+				if (k > start) config->latencySum += trace->time[k] - trace->time[start];
+			}
+			else
+				config->falseToggles++;
+		}
+
+		brightness = Brightness(sensor.predictedDistance);
+		if (wasInProximity && sensor.inProximity)
+		{
+			config->jitterSum += (brightness - previous) * (brightness - previous);
+			config->jitterCount++;
+		}
+		previous = brightness;
+	}
+
+	if (inEpisode && !hit) config->misses++;
+}
+
+int main(int argc, char** argv)
+{
+	uint8_t window = PS_WINDOW, fastWindow = PS_FAST_WINDOW;
+	float presence = PRESENCE_DISTANCE;
+	uint32_t grace = GRACE_MS, t, i;
+	SimTrace trace;
+	DualConfig configs[4];
+	char names[4][32];
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:w:d:g:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'f':
+				fastWindow = atoi(optarg);
+				break;
+			case 'w':
+				window = atoi(optarg);
+				break;
+			case 'd':
+				presence = atof(optarg);
+				break;
+			case 'g':
+				grace = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-f fast_window] [-w window] [-d distance] [-g grace_ms] trace...\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if (optind >= argc) { fprintf(stderr, "no traces\n"); return 2; }
+
+	memset(configs, 0, sizeof(configs));
+	snprintf(names[0], sizeof(names[0]), "raw");
+	snprintf(names[1], sizeof(names[1]), "mean %u", window);
+	snprintf(names[2], sizeof(names[2]), "mean %u", fastWindow);
+	snprintf(names[3], sizeof(names[3]), "fast %u + %u", fastWindow, window);
+	configs[0] = (DualConfig) { .name = names[0], .filter = SENSOR_FILTER_RAW, .window = window, .fastWindow = fastWindow };
+	configs[1] = (DualConfig) { .name = names[1], .filter = SENSOR_FILTER_MEAN, .window = window, .fastWindow = fastWindow };
+	configs[2] = (DualConfig) { .name = names[2], .filter = SENSOR_FILTER_MEAN, .window = fastWindow, .fastWindow = fastWindow };
+	configs[3] = (DualConfig) { .name = names[3], .filter = SENSOR_FILTER_FAST, .window = window, .fastWindow = fastWindow };
+
+	for (t = optind; t < (uint32_t) argc; t++)
+	{
+		if (SimTrace_Load(&trace, argv[t]) != 0) { fprintf(stderr, "%s: no time_ms,ps,als samples\n", argv[t]); return 2; }
+		if (trace.distance == NULL) { fprintf(stderr, "%s: not labeled with distances\n", argv[t]); return 2; }
+
+		for (i = 0; i < 4; i++) Replay(&configs[i], &trace, presence, grace);
+
+		free(trace.time);
+		free(trace.ps);
+		free(trace.als);
+		free(trace.distance);
+	}
+
+	printf("configuration  entries falseToggles misses latency[ms] brightnessJitter\n");
+	for (i = 0; i < 4; i++)
+	{
+		const DualConfig* c = &configs[i];
+		printf("%-14s %7u %12u %6u %11.1f %16.4f\n", c->name, c->entries, c->falseToggles, c->misses,
+			c->detected ? (double) c->latencySum / c->detected : 0, c->jitterCount ? sqrt(c->jitterSum / c->jitterCount) : 0);
+	}
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file bench_gen.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Benchmark of the synthetic PS/ALS workload generator
+ *
+ * Usage: bench_gen [samples] [seed] [trace_file] [trace_seconds]
+ *
+ * Checks that Distance_Lookup() of the noise free PS curve returns the hand distance, reports generation
+ * speed with the default events, and feeds the stream to a Sensor to count gestures against proximity
+ * entries and blocks. With trace_file, trace_seconds (default 60) of the same events sampled every 10 ms
+ * are written as time_ms,ps,als,distance lines, a labeled trace for replay, sweeps and calibration.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "Sensor.h"
+#include "SimGen.h"
+
+#define CHUNK_LEN 4096
+#define TRACE_SECONDS 60
+#define TRACE_PERIOD_US 10000
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+static double Elapsed_Ns(const struct timespec* start, const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t i, n = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000000ULL;
+	static uint16_t ps[CHUNK_LEN], als[CHUNK_LEN], distance[CHUNK_LEN];
+	static SimGen gen;
+	static Sensor sensor;
+	SimGenConfig config;
+	struct timespec start, end;
+	double genNs, error, maxError = 0;
+	uint32_t j, k, checksum = 0, entries = 0, blocks = 0;
+	uint8_t wasInProximity, wasBlocked;
+
+	SimGen_Default(&config);
+	if (argc > 2) config.seed = atoi(argv[2]);
+	Init_SimGen(&gen, &config, proximityTable);
+
+	//	Noise free samples, against the exact distance up to the last table entry
+	for (j = 0; j <= (uint32_t) distanceTable[DIST_LOOKUP_LEN - 1] << SIMGEN_CURVE_BITS; j++)
+	{
+		error = fabs(Distance_Lookup(gen.curve[j], proximityTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN) -
+			(double) j / (1 << SIMGEN_CURVE_BITS));
+		if (error > maxError) maxError = error;
+	}
+
+	if (argc > 3)
+	{
+		FILE* trace = fopen(argv[3], "w");
+		uint64_t traceLen = (argc > 4) ? strtoull(argv[4], NULL, 10) : TRACE_SECONDS;
+		SimGenConfig traceConfig = config;
+
+		if (trace == NULL) { perror(argv[3]); return 2; }
+
+		traceLen = traceLen * 1000000 / TRACE_PERIOD_US;
+		traceConfig.samplePeriod = TRACE_PERIOD_US;
+		Init_SimGen(&gen, &traceConfig, proximityTable);
+
+		fprintf(trace, "time_ms,ps,als,distance\n");
+		for (i = 0; i < traceLen; i += CHUNK_LEN)
+		{
+			k = (traceLen - i < CHUNK_LEN) ? traceLen - i : CHUNK_LEN;
+			SimGen_Fill(&gen, ps, als, distance, k);
+			for (j = 0; j < k; j++)
+				fprintf(trace, "%llu,%u,%u,%.3f\n", (unsigned long long) ((i + j) * TRACE_PERIOD_US / 1000), ps[j], als[j],
+					(double) distance[j] / SIMGEN_DISTANCE(1));
+		}
+		fclose(trace);
+		Init_SimGen(&gen, &config, proximityTable);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < n; i += CHUNK_LEN)
+	{
+		k = (n - i < CHUNK_LEN) ? n - i : CHUNK_LEN;
+		SimGen_Fill(&gen, ps, als, NULL, k);
+		checksum += ps[k - 1] + als[k / 2];
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	genNs = Elapsed_Ns(&start, &end);
+
+	printf("curve round trip error: %.4f distance units\n", maxError);
+	printf("samples: %llu, ns per sample: %.2f, %.0f M samples/s (checksum %u)\n",
+		(unsigned long long) n, genNs / n, n / genNs * 1e3, checksum);
+	printf("events: %u gestures, %u sunlight steps, %u IR noise bursts\n",
+		gen.gestureCount, gen.sunCount, gen.burstCount);
+
+	//	The same stream through the Sensor, at most 10 minutes of it
+	Init_SimGen(&gen, &config, proximityTable);
+	Init_Sensor(&sensor, 0, 680, 700, proximityTable);
+	for (i = 0; i < n && i < 600000000ULL / config.samplePeriod; i += CHUNK_LEN)
+	{
+		SimGen_Fill(&gen, ps, als, NULL, CHUNK_LEN);
+		for (j = 0; j < CHUNK_LEN; j++)
+		{
+			wasInProximity = sensor.inProximity;
+			wasBlocked = sensor.isBlocked;
+			Update_Sensor(&sensor, ps[j], als[j]);
+			if (!wasInProximity && sensor.inProximity) entries++;
+			if (!wasBlocked && sensor.isBlocked) blocks++;
+		}
+	}
+
+	printf("sensor over %.0f s: %u gestures, %u proximity entries, %u blocks\n",
+		gen.sampleCount * config.samplePeriod * 1e-6, gen.gestureCount, entries, blocks);
+
+	return (maxError < 0.25) ? 0 : 1;
+}
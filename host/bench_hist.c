@@ -0,0 +1,76 @@
+/**
+ * @file bench_hist.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Benchmark of Update_Sensor with plain and compressed histories
+ *
+ * Usage: bench_hist [updates]
+ *
+ * Built twice, as bench_hist and with SENSOR_COMPRESSED_HIST as bench_hist_compressed. Feeds a noisy PS/ALS
+ * signal with periodic hand approaches and reports history RAM, time and, on x86, TSC cycles per update.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Sensor.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+int main(int argc, char** argv)
+{
+	uint32_t i, n = (argc > 1) ? atoi(argv[1]) : 2000000;
+	uint16_t* ps = malloc(n * sizeof(uint16_t));
+	uint16_t* als = malloc(n * sizeof(uint16_t));
+	static Sensor sensor;
+	struct timespec start, end;
+	double ns;
+	uint64_t cycles = 0;
+	uint32_t checksum = 0;
+
+	//	Baseline with small noise, a 1 s hand approach every 5 s at 100 Hz
+	srand(1);
+	for (i = 0; i < n; i++)
+	{
+		uint32_t phase = i % 500;
+		ps[i] = 650 + rand() % 9 + ((phase < 100) ? (uint16_t) (phase * phase) : 0);
+		als[i] = 200 + rand() % 5;
+	}
+
+	Init_Sensor(&sensor, 0, 680, 700, proximityTable);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+#if defined(__x86_64__) || defined(__i386__)
+	cycles = __rdtsc();
+#endif
+	for (i = 0; i < n; i++)
+	{
+		Update_Sensor(&sensor, ps[i], als[i]);
+		checksum += sensor.psMean + sensor.inProximity;
+	}
+#if defined(__x86_64__) || defined(__i386__)
+	cycles = __rdtsc() - cycles;
+#endif
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+#ifdef SENSOR_COMPRESSED_HIST
+	printf("history: compressed, rebased ps %u\n", sensor.psHist.rebaseCount);
+#else
+	printf("history: plain\n");
+#endif
+	printf("history bytes: %zu\n", sizeof(sensor.psHist) + sizeof(sensor.alsHist));
+	printf("sizeof(Sensor): %zu\n", sizeof(Sensor));
+	printf("ns per update: %.1f\n", ns / n);
+	printf("tsc cycles per update: %.1f\n", (double) cycles / n);
+	printf("checksum: %u\n", checksum);
+
+	free(ps);
+	free(als);
+	return 0;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file bench_kalman.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Latency, accuracy and cost of the distance Kalman filter against the PS window mean
+ *
+ * Usage: bench_kalman [-a accel] [-n ps_noise] [-s seconds]
+ *
+ * Generates 100 Hz samples with bench_gen's generator: a script of slow and fast moves between 5 and 25
+ * cm with holds in between, without ambient events, then -s seconds (default 600) of random gestures with
+ * sunlight, IR bursts and drift. The sensor estimates distance from the window mean through the table, or
+ * with a SensorKalman (-a acceleration deviation in cm/s^2, default 2000, -n PS noise deviation in counts,
+ * default the generator's 3) per raw sample.
+ *
+ * Latency is the shift of the true distance that best matches the estimate over the script, hold noise the
+ * RMS error over its holds. Velocity error is against the true velocity over the script. Cost is the time
+ * and, on x86, the TSC cycles of one Update_Sensor_PS() call.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "Sensor.h"
+#include "SimGen.h"
+
+#define PERIOD_US 10000
+#define RANDOM_SECONDS 600
+#define KALMAN_ACCEL 2000
+
+/** @brief Largest latency searched (in samples) */
+#define MAX_SHIFT 50
+
+/** @brief Samples skipped after each move before hold noise is counted */
+#define SETTLE 30
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+static const SimGenEvent script[] = {
+	{ SIMGEN_APPROACH, SIMGEN_DISTANCE(25), 500 },
+	{ SIMGEN_HOLD, 0, 1500 },
+	{ SIMGEN_APPROACH, SIMGEN_DISTANCE(5), 1000 },
+	{ SIMGEN_HOLD, 0, 1500 },
+	{ SIMGEN_APPROACH, SIMGEN_DISTANCE(25), 1000 },
+	{ SIMGEN_HOLD, 0, 1500 },
+	{ SIMGEN_APPROACH, SIMGEN_DISTANCE(5), 250 },
+	{ SIMGEN_HOLD, 0, 1500 },
+	{ SIMGEN_APPROACH, SIMGEN_DISTANCE(25), 250 },
+	{ SIMGEN_HOLD, 0, 1500 }
+};
+
+/**
+ * @struct Result_t
+ * @brief Scores of one estimator
+ */
+typedef struct Result_t
+{
+	/** @brief Shift of the true distance best matching the estimate (in ms) */
+	double latency;
+
+	/** @brief RMS error at that shift (in cm) */
+	double shiftedError;
+
+	/** @brief RMS error over settled holds (in cm) */
+	double holdError;
+
+	/** @brief RMS velocity error over the script (in cm/s) */
+	double velocityError;
+
+	/** @brief RMS error over random gestures (in cm) */
+	double randomError;
+
+	/** @brief Time per Update_Sensor_PS() (in ns) */
+	double ns;
+
+	/** @brief TSC cycles per Update_Sensor_PS(), 0 if not on x86 */
+	double cycles;
+} Result;
+
+static double Elapsed_Ns(const struct timespec* start, const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+static uint64_t Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Generate labeled samples
+ */
+static void Generate(const SimGenConfig* config, const SimGenEvent* events, uint16_t eventCount, uint16_t* ps,
+	float* distance, uint32_t n)
+{
+	static SimGen gen;
+	static uint16_t als[4096], label[4096];
+	uint32_t i, j, k;
+
+	Init_SimGen(&gen, config, proximityTable);
+	SimGen_Script(&gen, events, eventCount);
+	for (i = 0; i < n; i += k)
+	{
+		k = (n - i < 4096) ? n - i : 4096;
+		SimGen_Fill(&gen, &ps[i], als, label, k);
+		for (j = 0; j < k; j++) distance[i + j] = (float) label[j] / SIMGEN_DISTANCE(1);
+	}
+}
+
+/**
+ * @brief Run a sensor over samples, recording estimatedDistance and estimatedVelocity
+ */
+static void Run(Sensor* sensor, SensorKalman* kalman, const uint16_t* ps, uint32_t n, double* distance, double* velocity)
+{
+	uint32_t k;
+
+	Init_Sensor(sensor, 0, 680, 700, proximityTable);
+	if (kalman != NULL) Set_Distance_Kalman(sensor, kalman);
+
+	for (k = 0; k < n; k++)
+	{
+		Update_Sensor_PS(sensor, ps[k]);
+		distance[k] = sensor->estimatedDistance;
+		if (velocity != NULL) velocity[k] = sensor->estimatedVelocity;
+	}
+}
+
+static double RMS_Error(const double* estimate, const float* truth, uint32_t n, uint32_t shift)
+{
+	double error, sum = 0;
+	uint32_t k, count = 0;
+
+	for (k = shift; k < n; k++)
+	{
+		if (truth[k - shift] > distanceTable[DIST_LOOKUP_LEN - 1] || truth[k] > distanceTable[DIST_LOOKUP_LEN - 1]) continue;
+		error = estimate[k] - truth[k - shift];
+		sum += error * error;
+		count++;
+	}
+
+	return count ? sqrt(sum / count) : 0;
+}
+
+static void Score(Result* result, SensorKalman* kalman, const uint16_t* ps, const float* truth, uint32_t n,
+	const uint16_t* randomPS, const float* randomTruth, uint32_t randomN)
+{
+	static Sensor sensor;
+	double* distance = malloc((n > randomN ? n : randomN) * sizeof(double));
+	double* velocity = malloc(n * sizeof(double));
+	double error, best = INFINITY, velocitySum = 0, holdSum = 0;
+	uint32_t k, shift, still = 0, holdCount = 0;
+	struct timespec start, end;
+	uint64_t cycles;
+
+	Run(&sensor, kalman, ps, n, distance, velocity);
+
+	for (shift = 0; shift <= MAX_SHIFT; shift++)
+	{
+		error = RMS_Error(distance, truth, n, shift);
+		if (error < best)
+		{
+			best = error;
+			result->latency = shift * PERIOD_US / 1000.0;
+		}
+	}
+	result->shiftedError = best;
+
+	for (k = 1; k + 1 < n; k++)
+	{
+		//	True velocity from the labels, holds once settled
+		error = velocity[k] - (truth[k + 1] - truth[k - 1]) * 1e6 / (2 * PERIOD_US);
+		velocitySum += error * error;
+
+		still = (truth[k] == truth[k - 1]) ? still + 1 : 0;
+		if (still >= SETTLE && truth[k] <= distanceTable[DIST_LOOKUP_LEN - 1])
+		{
+			error = distance[k] - truth[k];
+			holdSum += error * error;
+			holdCount++;
+		}
+	}
+	result->velocityError = sqrt(velocitySum / (n - 2));
+	result->holdError = holdCount ? sqrt(holdSum / holdCount) : 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	cycles = Cycles();
+	Run(&sensor, kalman, randomPS, randomN, distance, NULL);
+	cycles = Cycles() - cycles;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	result->randomError = RMS_Error(distance, randomTruth, randomN, 0);
+	result->ns = Elapsed_Ns(&start, &end) / randomN;
+	result->cycles = (double) cycles / randomN;
+
+	free(distance);
+	free(velocity);
+}
+
+static void Print(const char* name, const Result* r)
+{
+	printf("%-12s %7.0f %8.3f %8.3f %9.2f %8.3f %7.1f %7.0f\n", name, r->latency, r->shiftedError, r->holdError,
+		r->velocityError, r->randomError, r->ns, r->cycles);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t accel = KALMAN_ACCEL, psNoise, seconds = RANDOM_SECONDS, n = 0, randomN;
+	SimGenConfig config, randomConfig;
+	SensorKalman kalman;
+	Result mean, filtered;
+	uint16_t *ps, *randomPS;
+	float *truth, *randomTruth;
+	uint32_t i;
+	int opt;
+
+	SimGen_Default(&config);
+	psNoise = config.psNoise;
+
+	while ((opt = getopt(argc, argv, "a:n:s:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'a':
+				accel = atoi(optarg);
+				break;
+			case 'n':
+				psNoise = atoi(optarg);
+				break;
+			case 's':
+				seconds = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-a accel] [-n ps_noise] [-s seconds]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	config.samplePeriod = PERIOD_US;
+	randomConfig = config;
+	config.sunInterval = 0;
+	config.burstInterval = 0;
+	config.driftRate = 0;
+
+	for (i = 0; i < sizeof(script) / sizeof(script[0]); i++) n += script[i].duration;
+	n = n * 1000 / PERIOD_US;
+	randomN = seconds * (1000000 / PERIOD_US);
+
+	ps = malloc(n * sizeof(uint16_t));
+	truth = malloc(n * sizeof(float));
+	randomPS = malloc(randomN * sizeof(uint16_t));
+	randomTruth = malloc(randomN * sizeof(float));
+	Generate(&config, script, sizeof(script) / sizeof(script[0]), ps, truth, n);
+	Generate(&randomConfig, NULL, 0, randomPS, randomTruth, randomN);
+
+	Score(&mean, NULL, ps, truth, n, randomPS, randomTruth, randomN);
+	Init_Sensor_Kalman(&kalman, psNoise, accel, PERIOD_US);
+	Score(&filtered, &kalman, ps, truth, n, randomPS, randomTruth, randomN);
+
+	printf("%u Hz, script of %.1f s, %u s of random gestures, Kalman accel %u cm/s^2, PS noise %u\n",
+		1000000 / PERIOD_US, n * PERIOD_US * 1e-6, seconds, accel, psNoise);
+	printf("estimator    lag[ms] shifted     hold velocity   random   ns/up  cycles\n");
+	Print("window mean", &mean);
+	Print("kalman", &filtered);
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file bench_lag.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Perceived lag of the distance estimates on replayed labeled traces
+ *
+ * Usage: bench_lag [-w window] [-a accel] trace...
+ *
+ * Traces are time_ms,ps,als,distance lines of a single sample period, e.g. from bench_gen. Every trace is
+ * replayed through Update_Sensor_PS() with a -w sample PS window (default PS_WINDOW), once with a distance
+ * Kalman filter (-a acceleration deviation in cm/s^2, default 2000). Scored over the labeled samples within
+ * the table are estimatedDistance of the window mean, predictedDistance of the same window and
+ * estimatedDistance of the filter, as distances and as the lamp brightness processBatch() maps them to.
+ *
+ * Lag is the shift of the true value that best matches the estimate, error the RMS error without a shift,
+ * i.e. what the lamp shows.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#include "Sensor.h"
+#include "SimTrace.h"
+
+/** @brief Largest lag searched (in samples) */
+#define MAX_SHIFT 50
+
+#define KALMAN_ACCEL 2000
+#define KALMAN_PS_NOISE 3
+
+enum { EST_MEAN, EST_PREDICTED, EST_KALMAN, EST_COUNT };
+
+static const char* estimatorNames[EST_COUNT] = { "window mean", "predicted", "kalman" };
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+/**
+ * @struct Score_t
+ * @brief Squared errors of an estimator per shift, summed over the traces
+ */
+typedef struct Score_t
+{
+	double distanceSum[MAX_SHIFT + 1];
+	double brightnessSum[MAX_SHIFT + 1];
+	uint32_t count[MAX_SHIFT + 1];
+} Score;
+
+/**
+ * @brief Lamp brightness of a distance, as processBatch() computes intensity
+ */
+static double Brightness(double distance)
+{
+	double intensity = (distance < 5) ? 5 : distance;
+
+	intensity = tan((intensity - 5) / 20 * 0.8);
+	if (intensity < 0.008) intensity = 0.008;
+	return (intensity > 1) ? 1 : intensity;
+}
+
+static void Add_Trace(Score* score, const double* estimate, const float* truth, uint32_t n)
+{
+	const float last = distanceTable[DIST_LOOKUP_LEN - 1];
+	double error;
+	uint32_t k, shift;
+
+	for (shift = 0; shift <= MAX_SHIFT; shift++)
+		for (k = shift; k < n; k++)
+		{
+			if (truth[k - shift] > last || truth[k] > last) continue;
+
+			error = estimate[k] - truth[k - shift];
+			score->distanceSum[shift] += error * error;
+			error = Brightness(estimate[k]) - Brightness(truth[k - shift]);
+			score->brightnessSum[shift] += error * error;
+			score->count[shift]++;
+		}
+}
+
+/**
+ * @brief Shift with the smallest error
+ */
+static uint32_t Best_Shift(const double* sums, const uint32_t* counts)
+{
+	uint32_t shift, best = 0;
+
+	for (shift = 1; shift <= MAX_SHIFT; shift++)
+		if (counts[shift] && sums[shift] / counts[shift] < sums[best] / counts[best]) best = shift;
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	static Sensor sensor;
+	static Score scores[EST_COUNT];
+	SensorKalman kalman;
+	SimTrace trace;
+	uint32_t window = PS_WINDOW, accel = KALMAN_ACCEL, t, k, e, period = 0, samples = 0;
+	double* estimates[EST_COUNT];
+	int opt;
+
+	while ((opt = getopt(argc, argv, "w:a:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'w':
+				window = atoi(optarg);
+				break;
+			case 'a':
+				accel = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-w window] [-a accel] trace...\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if (optind >= argc) { fprintf(stderr, "no traces\n"); return 2; }
+
+	for (t = optind; t < (uint32_t) argc; t++)
+	{
+		if (SimTrace_Load(&trace, argv[t]) != 0) { fprintf(stderr, "%s: no time_ms,ps,als samples\n", argv[t]); return 2; }
+		if (trace.distance == NULL) { fprintf(stderr, "%s: not labeled with distances\n", argv[t]); return 2; }
+		if (period == 0) period = trace.duration / trace.length;
+
+		for (e = 0; e < EST_COUNT; e++) estimates[e] = malloc(trace.length * sizeof(double));
+
+		Init_Sensor(&sensor, 0, 0, UINT16_MAX, proximityTable);
+		Set_PS_Window(&sensor, window);
+		for (k = 0; k < trace.length; k++)
+		{
+			Update_Sensor_PS(&sensor, trace.ps[k]);
+			estimates[EST_MEAN][k] = sensor.estimatedDistance;
+			estimates[EST_PREDICTED][k] = sensor.predictedDistance;
+		}
+
+		Init_Sensor(&sensor, 0, 0, UINT16_MAX, proximityTable);
+		Init_Sensor_Kalman(&kalman, KALMAN_PS_NOISE, accel, period * 1000);
+		Set_Distance_Kalman(&sensor, &kalman);
+		for (k = 0; k < trace.length; k++)
+		{
+			Update_Sensor_PS(&sensor, trace.ps[k]);
+			estimates[EST_KALMAN][k] = sensor.estimatedDistance;
+		}
+
+		for (e = 0; e < EST_COUNT; e++)
+		{
+			Add_Trace(&scores[e], estimates[e], trace.distance, trace.length);
+			free(estimates[e]);
+		}
+
+		samples += trace.length;
+		free(trace.time);
+		free(trace.ps);
+		free(trace.als);
+		free(trace.distance);
+	}
+
+	printf("%d traces, %u samples, %u ms period, window %u\n", argc - optind, samples, period, window);
+	printf("estimator    distance lag[ms] error[cm]  brightness lag[ms] error\n");
+	for (e = 0; e < EST_COUNT; e++)
+	{
+		const Score* s = &scores[e];
+		uint32_t distanceLag = Best_Shift(s->distanceSum, s->count);
+		uint32_t brightnessLag = Best_Shift(s->brightnessSum, s->count);
+
+		printf("%-12s %16u %9.3f %19u %5.3f\n", estimatorNames[e], distanceLag * period,
+			sqrt(s->distanceSum[0] / s->count[0]), brightnessLag * period, sqrt(s->brightnessSum[0] / s->count[0]));
+	}
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file bench_lookup.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Benchmark of Distance_Lookup_Batch against one Distance_Lookup call per value
+ *
+ * Usage: bench_lookup [values]
+ *
+ * Maps the same PS values to distances both ways, checks every result is bit-exact and reports throughput.
+ * Values are drawn over the full 16 bit range and over the controller's working range, with the
+ * controller's proximity table, an unordered table for the first-match search and a table longer than
+ * one SIMD chunk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Sensor.h"
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+static uint16_t unorderedTable[DIST_LOOKUP_LEN] = {
+	30000, 18000, 19000, 2000, 1275, 1275, 920, 810, 765, 900, 720, 710, 700, 690, 680, 670
+};
+
+static uint16_t longTable[20] = {
+	60000, 50000, 40000, 30000, 20000, 15000, 10000, 8000, 6000, 5000,
+	4000, 3000, 2500, 2000, 1500, 1200, 1000, 900, 800, 700
+};
+
+static uint16_t longDistTable[20] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28
+};
+
+static double Elapsed_Ns(const struct timespec* start, const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+static uint32_t Run(const char* name, const uint16_t* ps, uint32_t n, uint16_t* proxTable, uint16_t* distTable, uint8_t tableLen)
+{
+	double* single = malloc(n * sizeof(double));
+	double* batch = malloc(n * sizeof(double));
+	struct timespec start, end;
+	double singleNs, batchNs;
+	uint32_t i, mismatches = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < n; i++)
+	{
+		single[i] = Distance_Lookup(ps[i], proxTable, distTable, tableLen);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	singleNs = Elapsed_Ns(&start, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	Distance_Lookup_Batch(ps, batch, n, proxTable, distTable, tableLen);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	batchNs = Elapsed_Ns(&start, &end);
+
+	for (i = 0; i < n; i++)
+	{
+		if (memcmp(&single[i], &batch[i], sizeof(double)) != 0) mismatches++;
+	}
+
+	printf("%-18s single %6.2f ns  batch %6.2f ns  %6.1f Mvalues/s  speedup %.2fx  mismatches %u\n",
+		name, singleNs / n, batchNs / n, n / batchNs * 1e3, singleNs / batchNs, mismatches);
+
+	free(single);
+	free(batch);
+	return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t i, n = (argc > 1) ? atoi(argv[1]) : 4000001;
+	uint16_t* full = malloc(n * sizeof(uint16_t));
+	uint16_t* working = malloc(n * sizeof(uint16_t));
+	uint32_t mismatches = 0;
+
+#ifdef __SSE2__
+	printf("Distance_Lookup_Batch: SSE2\n");
+#else
+	printf("Distance_Lookup_Batch: scalar\n");
+#endif
+
+	srand(1);
+	for (i = 0; i < n; i++)
+	{
+		full[i] = (uint16_t) rand();
+		working[i] = 600 + rand() % 1500;
+	}
+
+	mismatches += Run("full range", full, n, proximityTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN);
+	mismatches += Run("working range", working, n, proximityTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN);
+	mismatches += Run("unordered table", full, n, unorderedTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN);
+	mismatches += Run("20 entry table", full, n, longTable, longDistTable, 20);
+
+	free(full);
+	free(working);
+	return mismatches ? 1 : 0;
+}
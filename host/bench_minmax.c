@@ -0,0 +1,141 @@
+/**
+ * @file bench_minmax.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Sliding window minimum and maximum against a naive rescan of the history
+ *
+ * Usage: bench_minmax [samples]
+ *
+ * Feeds noisy PS/ALS samples with hand approaches, a long fall and rise and a covered stretch, for PS windows
+ * of 5, 25 and 50 samples. After every sample psMin, psMax, alsMin and alsMax are checked against a rescan of
+ * the window within psHist and alsHist. Cost is the time and, on x86, the TSC cycles per sample of
+ * Update_Sensor_Batch(), which takes no STD, and of the rescan of psHist alone.
+ *
+ * bench_minmax takes the minimum and maximum in the STD pass, so its batch has none to update.
+ * bench_minmax_deque is built with SENSOR_MINMAX_DEQUE, where the batch keeps the deques on every sample.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "Sensor.h"
+
+#define BATCH_LEN 64
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+static double Elapsed_Ns(const struct timespec* start, const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+static uint64_t Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Minimum and maximum of the latest window samples of psHist or alsHist, by rescanning it
+ */
+static void Rescan(const Sensor* sensor, uint8_t als, uint32_t count, uint8_t window, uint8_t fill, uint16_t* min,
+	uint16_t* max)
+{
+	uint8_t i, len = (fill + 1 < window) ? fill + 1 : window;
+	uint16_t value;
+
+	*min = UINT16_MAX;
+	*max = 0;
+	for (i = 0; i < len; i++)
+	{
+		value = als ? sensor->alsHist[(count - i) % SENSOR_HIST_LEN] : sensor->psHist[(count - i) % SENSOR_HIST_LEN];
+		if (value < *min) *min = value;
+		if (value > *max) *max = value;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint8_t windows[3] = { 5, 25, 50 };
+	uint32_t i, k, n = (argc > 1) ? atoi(argv[1]) : 2000000;
+	uint16_t* ps = malloc(n * sizeof(uint16_t));
+	uint16_t* als = malloc(n * sizeof(uint16_t));
+	uint16_t min, max, psMin = 0, psMax = 0;
+	static Sensor sensor;
+	struct timespec start, end;
+	uint64_t cycles;
+	double ns;
+	uint32_t mismatches = 0;
+	volatile uint32_t sink = 0;
+
+	//	Noise with hand approaches, every 2000 samples a long fall and rise, and a covered stretch
+	srand(1);
+	for (i = 0; i < n; i++)
+	{
+		uint32_t phase = i % 2000;
+		ps[i] = 650 + rand() % 16;
+		als[i] = 200 + rand() % 8;
+		if (phase < 300) ps[i] += (phase < 150 ? phase : 300 - phase) * 20;
+		else if (phase < 1000) ps[i] += (phase < 650 ? phase - 300 : 1000 - phase);
+		else if (phase >= 1800) { ps[i] = 65535; als[i] = 0; }
+	}
+
+	printf("window  mismatches  batch[ns] batch[cyc]  rescan[ns] rescan[cyc]\n");
+	for (k = 0; k < 3; k++)
+	{
+		//	Every sample checked against the rescan
+		Init_Sensor(&sensor, 0, 680, 700, proximityTable);
+		Set_PS_Window(&sensor, windows[k]);
+		mismatches = 0;
+		for (i = 0; i < n; i++)
+		{
+			Update_Sensor(&sensor, ps[i], als[i]);
+			Rescan(&sensor, 0, sensor.sampleCount - 1, sensor.psWindow, sensor.psWindowFill - 1, &min, &max);
+			mismatches += (min != sensor.psMin) || (max != sensor.psMax);
+			Rescan(&sensor, 1, sensor.alsSampleCount - 1, ALS_WINDOW, sensor.alsWindowFill - 1, &min, &max);
+			mismatches += (min != sensor.alsMin) || (max != sensor.alsMax);
+		}
+
+		//	Deques within the batch, which leaves out the STD loops
+		Init_Sensor(&sensor, 0, 680, 700, proximityTable);
+		Set_PS_Window(&sensor, windows[k]);
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		cycles = Cycles();
+		for (i = 0; i + BATCH_LEN <= n; i += BATCH_LEN)
+		{
+			Update_Sensor_Batch(&sensor, &ps[i], NULL, BATCH_LEN);
+			sink += sensor.psMax;
+		}
+		cycles = Cycles() - cycles;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		ns = Elapsed_Ns(&start, &end) / i;
+		printf("%6u %11u %10.1f %10.0f", windows[k], mismatches, ns, (double) cycles / i);
+
+		//	Rescan alone over the same history, as if done after every sample
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		cycles = Cycles();
+		for (i = 0; i < n; i++)
+		{
+			sensor.psHist[i % SENSOR_HIST_LEN] = ps[i];
+			Rescan(&sensor, 0, i, windows[k], (i < SENSOR_HIST_LEN) ? i : SENSOR_HIST_LEN, &min, &max);
+			psMin += min;
+			psMax += max;
+		}
+		cycles = Cycles() - cycles;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		printf(" %11.1f %11.0f\n", Elapsed_Ns(&start, &end) / n, (double) cycles / n);
+	}
+
+	sink += psMin + psMax;
+	free(ps);
+	free(als);
+	return (mismatches > 0) || (sink == 0);
+}
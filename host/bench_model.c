@@ -0,0 +1,215 @@
+/**
+ * @file bench_model.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Accuracy and speed of the inverse-square distance model against the proximity table
+ *
+ * Usage: bench_model [-m a,b,c] trace...
+ *
+ * Traces are labeled time_ms,ps,als,distance lines, e.g. from bench_gen or a labeled bench recording. The
+ * model parameters are those printed by calibrate for the same unit, by default its fit of bench_gen traces
+ * of the controller's proximity table. Reports the largest error of the fixed point Distance_Model()
+ * against the model in double precision over every PS value, then per #distanceTable segment the RMS
+ * distance error of the table and the model on raw PS values, the RMS error of estimatedDistance with
+ * either through Update_Sensor_PS(), and the time per value of Distance_Lookup() and Distance_Model().
+ *
+ * Times are of the host; on the controller the PROBE_DISTANCE_LOOKUP histogram times whichever is in use.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include "Sensor.h"
+#include "SimTrace.h"
+
+/*
+ * calibrate's model of bench_gen traces of the proximity table below
+ */
+#define MODEL_A 39778.6
+#define MODEL_B 0.01
+#define MODEL_C 632.5
+
+/** @brief Timed passes over the PS values */
+#define TIMING_PASSES 20
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+/**
+ * @struct Segment_t
+ * @brief Squared distance errors within a #distanceTable segment
+ */
+typedef struct Segment_t
+{
+	uint32_t samples;
+	double tableErrorSum;
+	double modelErrorSum;
+} Segment;
+
+static double Elapsed_Ns(const struct timespec* start, const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @brief Model distance in double precision, clamped as Distance_Model() does
+ */
+static double Exact_Distance(uint16_t ps, double a, double b, double c)
+{
+	double d = (ps > floor(c + 0.5)) ? sqrt(a / (ps - floor(c + 0.5))) - b : distanceTable[DIST_LOOKUP_LEN - 1];
+
+	if (d < distanceTable[0]) return distanceTable[0];
+	return (d > distanceTable[DIST_LOOKUP_LEN - 1]) ? distanceTable[DIST_LOOKUP_LEN - 1] : d;
+}
+
+/**
+ * @brief Segment of a labeled distance, 0 beyond the table
+ */
+static int Find_Segment(float distance)
+{
+	int i;
+
+	if (distance < distanceTable[0] || distance > distanceTable[DIST_LOOKUP_LEN - 1]) return 0;
+	for (i = 1; i < DIST_LOOKUP_LEN - 1 && distance > distanceTable[i]; i++);
+	return i;
+}
+
+/**
+ * @brief RMS error of estimatedDistance over a trace's labeled samples within the table
+ *
+ * @param [in] traces
+ * @param [in] traceCount
+ * @param [in] model distance model, NULL for the table
+ * @return RMS error (in distance units)
+ */
+static double Sensor_Error(const SimTrace* traces, uint32_t traceCount, const SensorModel* model)
+{
+	static Sensor sensor;
+	double error, errorSum = 0;
+	uint32_t t, k, count = 0;
+
+	for (t = 0; t < traceCount; t++)
+	{
+		Init_Sensor(&sensor, 0, 0, UINT16_MAX, proximityTable);
+		Set_Distance_Model(&sensor, model);
+
+		for (k = 0; k < traces[t].length; k++)
+		{
+			Update_Sensor_PS(&sensor, traces[t].ps[k]);
+			if (Find_Segment(traces[t].distance[k]) == 0) continue;
+
+			error = sensor.estimatedDistance - traces[t].distance[k];
+			errorSum += error * error;
+			count++;
+		}
+	}
+
+	return count ? sqrt(errorSum / count) : 0;
+}
+
+int main(int argc, char** argv)
+{
+	double a = MODEL_A, b = MODEL_B, c = MODEL_C;
+	SensorModel model;
+	Segment segments[DIST_LOOKUP_LEN];
+	SimTrace* traces;
+	uint32_t traceCount, t, k, i, n = 0, samples = 0;
+	uint16_t* values;
+	double error, maxError = 0, tableErrorSum = 0, modelErrorSum = 0, tableNs, modelNs, sink = 0;
+	struct timespec start, end;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "m:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'm':
+				if (sscanf(optarg, "%lf,%lf,%lf", &a, &b, &c) != 3) { fprintf(stderr, "-m expects a,b,c\n"); return 2; }
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-m a,b,c] trace...\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if (optind >= argc) { fprintf(stderr, "no traces\n"); return 2; }
+
+	Init_Distance_Model(&model, a, b, c);
+
+	//	Fixed point against double precision, every PS value
+	for (k = 0; k <= UINT16_MAX; k++)
+	{
+		error = fabs(Distance_Model(k, &model) - Exact_Distance(k, a, b, c));
+		if (error > maxError) maxError = error;
+	}
+
+	traceCount = argc - optind;
+	traces = calloc(traceCount, sizeof(SimTrace));
+	for (t = 0; t < traceCount; t++)
+	{
+		const char* path = argv[optind + t];
+
+		if (SimTrace_Load(&traces[t], path) != 0) { fprintf(stderr, "%s: no time_ms,ps,als samples\n", path); return 2; }
+		if (traces[t].distance == NULL) { fprintf(stderr, "%s: not labeled with distances\n", path); return 2; }
+		samples += traces[t].length;
+	}
+
+	//	Raw PS values within the table, per segment
+	values = malloc(samples * sizeof(uint16_t));
+	memset(segments, 0, sizeof(segments));
+	for (t = 0; t < traceCount; t++)
+		for (k = 0; k < traces[t].length; k++)
+		{
+			uint16_t ps = traces[t].ps[k];
+			float distance = traces[t].distance[k];
+
+			i = Find_Segment(distance);
+			if (i == 0) continue;
+
+			segments[i].samples++;
+			error = Distance_Lookup(ps, proximityTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN) - distance;
+			segments[i].tableErrorSum += error * error;
+			error = Distance_Model(ps, &model) - distance;
+			segments[i].modelErrorSum += error * error;
+			values[n++] = ps;
+		}
+
+	//	Both over the same values, which are in the working range
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < TIMING_PASSES; i++)
+		for (k = 0; k < n; k++) sink += Distance_Lookup(values[k], proximityTable, (uint16_t *) distanceTable, DIST_LOOKUP_LEN);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	tableNs = Elapsed_Ns(&start, &end) / ((double) n * TIMING_PASSES);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < TIMING_PASSES; i++)
+		for (k = 0; k < n; k++) sink += Distance_Model(values[k], &model);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	modelNs = Elapsed_Ns(&start, &end) / ((double) n * TIMING_PASSES);
+
+	printf("model: a = %.1f, b = %.3f, c = %.1f, fixed point scale %u, bias %d, offset %u\n",
+		a, b, c, (unsigned) model.scale, model.bias, model.offset);
+	printf("fixed point error: %.4f distance units at most\n", maxError);
+	printf("%u traces, %u samples, %u within the table\n", traceCount, samples, n);
+
+	printf("segment,from,to,samples,tableError,modelError\n");
+	for (i = 1; i < DIST_LOOKUP_LEN; i++)
+	{
+		Segment* s = &segments[i];
+		tableErrorSum += s->tableErrorSum;
+		modelErrorSum += s->modelErrorSum;
+		printf("%u,%u,%u,%u,%.3f,%.3f\n", i, distanceTable[i - 1], distanceTable[i], s->samples,
+			s->samples ? sqrt(s->tableErrorSum / s->samples) : 0, s->samples ? sqrt(s->modelErrorSum / s->samples) : 0);
+	}
+
+	printf("raw PS error: table %.3f, model %.3f\n", n ? sqrt(tableErrorSum / n) : 0, n ? sqrt(modelErrorSum / n) : 0);
+	printf("estimatedDistance error: table %.3f, model %.3f\n",
+		Sensor_Error(traces, traceCount, NULL), Sensor_Error(traces, traceCount, &model));
+	printf("ns per value: Distance_Lookup %.2f, Distance_Model %.2f (checksum %.0f)\n", tableNs, modelNs, sink);
+
+	return (maxError < 0.05) ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file bench_queue.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Stress of the SPSC sample queue with a producer thread standing in for the ISR
+ *
+ * Usage: bench_queue [samples] [stall_every] [burst]
+ *
+ * The producer pushes numbered samples in bursts, yielding the CPU after each burst like a periodic ISR
+ * returning; the consumer drains in batches, yields when the queue is empty, and stalls for a while every
+ * stall_every batches, like a loop held up by telemetry. This interleaves both sides on a single core as
+ * well as running them truly concurrently on several. Every sample must arrive exactly once
+ * and in order unless it was counted as an overflow; fails otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "SampleQueue.h"
+
+#define BATCH 8
+#define STALL_SPIN 2000
+
+static SampleQueue queue;
+static uint32_t total;
+static uint32_t burst;
+static volatile int producing = 1;
+
+static void* Producer(void* arg)
+{
+	uint32_t i;
+
+	for (i = 0; i < total; i++)
+	{
+		SampleQueue_Push(&queue, i, (uint16_t) i, (uint16_t) (i >> 16), SAMPLE_PS | SAMPLE_ALS);
+		if ((i + 1) % burst == 0) sched_yield();
+	}
+
+	__atomic_store_n(&producing, 0, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t stallEvery = (argc > 2) ? atoi(argv[2]) : 64;
+	uint32_t received = 0, errors = 0, batches = 0, expected = 0, gap;
+	uint8_t i, count;
+	SampleEntry batch[BATCH];
+	pthread_t producer;
+	struct timespec start, end;
+	double seconds;
+	volatile uint32_t spin;
+
+	total = (argc > 1) ? atoi(argv[1]) : 2000000;
+	burst = (argc > 3) ? atoi(argv[3]) : 4;
+	if (burst == 0) burst = 1;
+	Init_SampleQueue(&queue);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	pthread_create(&producer, NULL, Producer, NULL);
+
+	for (;;)
+	{
+		int done = !__atomic_load_n(&producing, __ATOMIC_ACQUIRE);
+
+		count = SampleQueue_Pop(&queue, batch, BATCH);
+		for (i = 0; i < count; i++)
+		{
+			//	Gaps are allowed only up to the overflows counted so far
+			if ((batch[i].time < expected) || (batch[i].psVal != (uint16_t) batch[i].time) ||
+				(batch[i].alsVal != (uint16_t) (batch[i].time >> 16)))
+				errors++;
+			expected = batch[i].time + 1;
+			received++;
+		}
+
+		if (count == 0)
+		{
+			if (done) break;
+			sched_yield();
+		}
+
+		if (stallEvery && (++batches % stallEvery == 0))
+			for (spin = 0; spin < STALL_SPIN; spin++);
+	}
+
+	pthread_join(producer, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+	gap = total - received;
+	printf("pushed: %u, received: %u, overflows: %u, high water: %u/%d\n", total, received,
+			queue.overflowCount, (unsigned) queue.highWater, SAMPLE_QUEUE_LEN);
+	printf("throughput: %.1f M samples/s\n", received / seconds / 1e6);
+	printf("ordering/content errors: %u\n", errors);
+
+	if (errors || (gap != queue.overflowCount))
+	{
+		printf("FAIL: %u missing, %u overflows counted\n", gap, queue.overflowCount);
+		return 1;
+	}
+
+	return 0;
+}
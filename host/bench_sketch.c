@@ -0,0 +1,165 @@
+/**
+ * @file bench_sketch.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Accuracy, merge and cost of the SensorSketch quantiles against exact ones
+ *
+ * Usage: bench_sketch [-u units] [-s seconds]
+ *
+ * Generates -s seconds (default 600) of 100 Hz samples with bench_gen's generator for each of -u units
+ * (default 4, one seed each), counted into a PS and an ALS sketch per unit through Update_Sensor(). Reported
+ * are the p5, p50 and p95 of the first unit and of all units merged, exact from a full histogram and from
+ * the sketches, and the time of one Sensor_Sketch_Add().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "Sensor.h"
+#include "SimGen.h"
+
+#define PERIOD_US 10000
+#define SECONDS 600
+#define UNITS 4
+#define PS_MIN_HYST 680
+#define PS_MAX_HYST 700
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+static const double quantiles[3] = { 0.05, 0.5, 0.95 };
+
+static double Elapsed_Ns(const struct timespec* start, const struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @brief Exact quantile of a full histogram of 16-bit values, lowest value with rank at least q n
+ */
+static uint16_t Exact_Quantile(const uint32_t* hist, uint64_t n, double q)
+{
+	uint64_t below = 0;
+	uint32_t v;
+
+	for (v = 0; v < 65536; v++)
+	{
+		below += hist[v];
+		if (below > 0 && below >= q * n) return (uint16_t) v;
+	}
+	return UINT16_MAX;
+}
+
+static void Print(const char* name, const uint32_t* hist, uint64_t n, const SensorSketch* sketch)
+{
+	uint8_t i;
+	double exact, estimate;
+
+	printf("%-10s", name);
+	for (i = 0; i < 3; i++)
+	{
+		exact = Exact_Quantile(hist, n, quantiles[i]);
+		estimate = Sensor_Sketch_Quantile(sketch, quantiles[i]);
+		printf(" %7.0f %8.1f %5.1f%%", exact, estimate, exact ? 100 * (estimate - exact) / exact : 0);
+	}
+	printf("   %u\n", sketch->halvings);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t seconds = SECONDS, units = UNITS, n, u, k;
+	static uint32_t psHist[2][65536], alsHist[2][65536];
+	static uint16_t ps[4096], als[4096];
+	static SimGen gen;
+	static Sensor sensor;
+	SensorSketch psSketch, alsSketch, psMerged, alsMerged, first[2];
+	SimGenConfig config;
+	struct timespec start, end;
+	volatile uint32_t sink = 0;
+	uint16_t* values;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "u:s:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'u':
+				units = atoi(optarg);
+				break;
+			case 's':
+				seconds = atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-u units] [-s seconds]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if (units < 1) units = 1;
+	n = seconds * (1000000 / PERIOD_US);
+	Init_Sensor_Sketch(&psMerged);
+	Init_Sensor_Sketch(&alsMerged);
+
+	for (u = 0; u < units; u++)
+	{
+		SimGen_Default(&config);
+		config.samplePeriod = PERIOD_US;
+		config.seed = u + 1;
+		Init_SimGen(&gen, &config, proximityTable);
+
+		Init_Sensor(&sensor, 0, PS_MIN_HYST, PS_MAX_HYST, proximityTable);
+		Init_Sensor_Sketch(&psSketch);
+		Init_Sensor_Sketch(&alsSketch);
+		Set_Sensor_Sketch(&sensor, &psSketch, &alsSketch);
+
+		for (k = 0; k < n; k++)
+		{
+			if (k % 4096 == 0) SimGen_Fill(&gen, ps, als, NULL, (n - k < 4096) ? n - k : 4096);
+			Update_Sensor(&sensor, ps[k % 4096], als[k % 4096]);
+
+			psHist[1][ps[k % 4096]]++;
+			alsHist[1][als[k % 4096]]++;
+			if (u == 0)
+			{
+				psHist[0][ps[k % 4096]]++;
+				alsHist[0][als[k % 4096]]++;
+			}
+		}
+
+		if (u == 0)
+		{
+			first[0] = psSketch;
+			first[1] = alsSketch;
+		}
+
+		//	As the host merges telemetry dumps of several units
+		Sensor_Sketch_Merge(&psMerged, &psSketch);
+		Sensor_Sketch_Merge(&alsMerged, &alsSketch);
+	}
+
+	//	Update cost alone, over the last unit's PS values
+	values = malloc(n * sizeof(uint16_t));
+	Init_SimGen(&gen, &config, proximityTable);
+	for (k = 0; k < n; k += 4096) SimGen_Fill(&gen, &values[k], als, NULL, (n - k < 4096) ? n - k : 4096);
+	Init_Sensor_Sketch(&psSketch);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (k = 0; k < n; k++) Sensor_Sketch_Add(&psSketch, values[k]);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	sink += psSketch.total;
+
+	printf("%u units of %u s at %u Hz, %u buckets of %u bytes\n", units, seconds, 1000000 / PERIOD_US,
+		SENSOR_SKETCH_LEN, (unsigned) sizeof(SensorSketch));
+	printf("%-10s %7s %8s %6s %7s %8s %6s %7s %8s %6s   halvings\n", "sketch", "p5", "sketch", "err", "p50",
+		"sketch", "err", "p95", "sketch", "err");
+	Print("ps", psHist[0], n, &first[0]);
+	Print("als", alsHist[0], n, &first[1]);
+	Print("ps merged", psHist[1], (uint64_t) n * units, &psMerged);
+	Print("als merged", alsHist[1], (uint64_t) n * units, &alsMerged);
+	printf("ns per Sensor_Sketch_Add: %.1f\n", Elapsed_Ns(&start, &end) / n);
+
+	free(values);
+	return sink == 0;
+}
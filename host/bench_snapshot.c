@@ -0,0 +1,119 @@
+/**
+ * @file bench_snapshot.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Concurrent readers against a publishing writer on the Sensor snapshot
+ *
+ * Usage: bench_snapshot [readers] [seconds]
+ *
+ * The writer thread publishes sensors whose every field is derived from one counter; reader threads check
+ * each snapshot they read is internally consistent. Reports publish and read rates, retries and torn reads,
+ * and fails on any torn read.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "Snapshot.h"
+
+#define MAX_READERS 64
+
+typedef struct ReaderStats_t
+{
+	uint64_t reads;
+	uint64_t retries;
+	uint64_t torn;
+} ReaderStats;
+
+static SnapshotCell cell;
+static volatile int running = 1;
+static uint64_t published = 0;
+
+/**
+ * @brief Fill sensor outputs from a single counter
+ */
+static void Fill_Sensor(Sensor* sensor, uint32_t k)
+{
+	sensor->sampleCount = k;
+	sensor->psMean = (uint16_t) k;
+	sensor->alsMean = (uint16_t) (k * 3);
+	sensor->psSTD = k;
+	sensor->alsSTD = 2.0 * k;
+	sensor->estimatedDistance = 0.5 * k;
+	sensor->psOffset = (int16_t) (k * 5);
+	sensor->inProximity = k & 1;
+	sensor->isBlocked = (k >> 1) & 1;
+}
+
+static void* Writer(void* arg)
+{
+	static Sensor sensor;
+	uint32_t k = 0;
+
+	while (running)
+	{
+		Fill_Sensor(&sensor, ++k);
+		Snapshot_Publish(&cell, &sensor, (uint16_t) (k * 7), (uint16_t) (k * 11), k / 2);
+	}
+
+	published = k;
+	return NULL;
+}
+
+static void* Reader(void* arg)
+{
+	ReaderStats* stats = arg;
+	SensorSnapshot snap;
+	uint32_t k;
+
+	while (running)
+	{
+		stats->retries += Snapshot_Read(&cell, &snap);
+		stats->reads++;
+
+		k = snap.sampleCount;
+		if ((snap.psMean != (uint16_t) k) || (snap.alsMean != (uint16_t) (k * 3)) || (snap.psSTD != k) ||
+			(snap.alsSTD != 2.0 * k) || (snap.estimatedDistance != 0.5 * k) || (snap.inProximity != (k & 1)) ||
+			(snap.isBlocked != ((k >> 1) & 1)) || (snap.psOffset != (int16_t) (k * 5)) ||
+			(snap.psVal != (uint16_t) (k * 7)) || (snap.alsVal != (uint16_t) (k * 11)) || (snap.toggleCount != k / 2))
+			stats->torn++;
+	}
+
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	int i, readers = (argc > 1) ? atoi(argv[1]) : 3;
+	double seconds = (argc > 2) ? atof(argv[2]) : 2;
+	pthread_t writer, threads[MAX_READERS];
+	static ReaderStats stats[MAX_READERS];
+	ReaderStats total = {0, 0, 0};
+
+	if (readers > MAX_READERS) readers = MAX_READERS;
+
+	Init_Snapshot(&cell);
+	pthread_create(&writer, NULL, Writer, NULL);
+	for (i = 0; i < readers; i++)
+		pthread_create(&threads[i], NULL, Reader, &stats[i]);
+
+	usleep((useconds_t) (seconds * 1e6));
+	running = 0;
+
+	pthread_join(writer, NULL);
+	for (i = 0; i < readers; i++)
+	{
+		pthread_join(threads[i], NULL);
+		total.reads += stats[i].reads;
+		total.retries += stats[i].retries;
+		total.torn += stats[i].torn;
+	}
+
+	printf("publishes per second: %.0f\n", published / seconds);
+	printf("reads per second: %.0f (%d readers)\n", total.reads / seconds, readers);
+	printf("retries per read: %.3f\n", (double) total.retries / total.reads);
+	printf("torn reads: %llu\n", (unsigned long long) total.torn);
+
+	return total.torn ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file bus_sim.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Multi-sensor bus scheduler run against the simulated I2C bus
+ *
+ * Usage: bus_sim [sensors] [seconds] [period_us] [conversion_us]
+ *
+ * Sensors alternate between a mux channel and being attached directly. Reports samples per sensor and per
+ * 10 ms frame, bus utilization, mux selects, and checks the pipelined timing model: no PS result may be read
+ * while its conversion is still running, either from the firmware or the device point of view.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "BusScheduler.h"
+#include "SimClock.h"
+#include "SimI2C.h"
+
+#define MUX_ADDR 0x70
+#define FRAME_US 10000
+#define IDLE_STEP_US 10
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+/**
+ * @brief PS signal, slow hand wave with a per-sensor phase
+ */
+static uint16_t Wave_PS(void* ctx, uint64_t now)
+{
+	double phase = (double) (intptr_t) ctx;
+	return (uint16_t) (700 + 300 * sin(2 * M_PI * ((double) now / 2e6) + phase));
+}
+
+int main(int argc, char** argv)
+{
+	uint8_t i, count = (argc > 1) ? atoi(argv[1]) : BUS_MAX_SENSORS;
+	double seconds = (argc > 2) ? atof(argv[2]) : 10;
+	uint32_t period = (argc > 3) ? atoi(argv[3]) : 10000;
+	uint32_t conversion = (argc > 4) ? atoi(argv[4]) : 1000;
+	uint64_t end;
+	uint32_t early = 0, stale = 0, errors = 0;
+	static Sensor sensors[BUS_MAX_SENSORS];
+	BusScheduler bus;
+	BusSensor* entry;
+	int status = 0;
+
+	if (count > BUS_MAX_SENSORS) count = BUS_MAX_SENSORS;
+
+	Init_SimBus(MUX_ADDR, SIM_BYTE_TIME_US);
+	Init_BusScheduler(&bus, MUX_ADDR, SimI2C_Read, SimI2C_Write, SimI2C_Select, Sim_Micros);
+
+	//	Same address behind the mux on odd indices, distinct direct addresses on even ones
+	for (i = 0; i < count; i++)
+	{
+		uint8_t address = (i % 2) ? 0x51 : (uint8_t) (0x60 + i);
+		uint8_t channel = (i % 2) ? (uint8_t) (i / 2) : BUS_NO_MUX;
+
+		SimBus_Add(address, channel, conversion, Wave_PS, NULL, (void*) (intptr_t) i);
+		Init_Sensor(&sensors[i], i, 680, 700, proximityTable);
+		BusScheduler_Add(&bus, address, channel, &sensors[i], period, conversion);
+
+		BusScheduler_Write(&bus, i, 0x03, 0x3E, 0x4B);
+		BusScheduler_Write(&bus, i, BUS_CMD_PS_CONF3_MS, 0x09, 0x07);
+	}
+
+	BusScheduler_Reset_Stats(&bus);
+	end = Sim_Now() + (uint64_t) (seconds * 1e6);
+	while (Sim_Now() < end)
+	{
+		if (BusScheduler_Poll(&bus) == 0) Sim_Advance(IDLE_STEP_US);
+	}
+
+	printf("sensor,address,channel,samples,early,stale,errors,lastAge,maxAge,psMean\n");
+	for (i = 0; i < count; i++)
+	{
+		entry = &bus.sensors[i];
+		printf("%u,0x%02X,%d,%u,%u,%u,%u,%u,%u,%u\n", i, entry->regs.address,
+				(entry->muxChannel == BUS_NO_MUX) ? -1 : entry->muxChannel, entry->pipeline.readCount,
+				entry->pipeline.earlyCount, simBus.devices[i].staleCount, entry->errorCount,
+				entry->pipeline.lastAge, entry->pipeline.maxAge, entry->sensor->psMean);
+		early += entry->pipeline.earlyCount;
+		stale += simBus.devices[i].staleCount;
+		errors += entry->errorCount;
+	}
+
+	printf("samples per frame: %.2f\n", (double) bus.sampleCount * FRAME_US / (seconds * 1e6));
+	printf("bus utilization: %.1f%%\n", BusScheduler_Utilization(&bus) / 10.0);
+	printf("mux selects: %u\n", bus.selectCount);
+
+	if (early || stale || errors)
+	{
+		printf("FAIL: %u early, %u stale, %u errors\n", early, stale, errors);
+		status = 1;
+	}
+
+	return status;
+}
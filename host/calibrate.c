@@ -0,0 +1,403 @@
+/**
+ * @file calibrate.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief proximityTable calibration from labeled traces
+ *
+ * Usage: calibrate [-p nominal_table] trace...
+ *
+ * Traces are time_ms,ps,als,distance lines of one unit, e.g. from bench_gen or a labeled bench recording.
+ * The PS curve is fitted as the piecewise linear function through the #distanceTable knots that
+ * Distance_Lookup() interpolates: a least squares fit of the 16 knot PS values, a tridiagonal system pulled
+ * weakly towards the nominal table (-p, comma separated, default the sketch's) so knots without samples keep
+ * their nominal value. A second pass drops samples beyond 4 standard deviations of their segment's residual,
+ * e.g. IR noise bursts, and the knots are then made non-increasing as Distance_Lookup() expects.
+ *
+ * The inverse-square model PS = a / (d + b)^2 + c is fitted as well, scanning b and solving a, c by least
+ * squares weighted towards distance error. b may be negative down to where the nearest sample's d + b
+ * vanishes; a b on that limit is reported, as the curve is then steeper near the sensor than the model. The new proximityTable is printed as a C initialiser, then the
+ * model parameters, and per segment the number of samples, the PS residual and the RMS distance error of
+ * the nominal and the fitted table, each a single pass over the samples.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include "Sensor.h"
+#include "SimTrace.h"
+
+/** @brief Weight of the nominal table, in samples */
+#define PRIOR_WEIGHT 1.0
+
+/** @brief Residual beyond which a sample is dropped, in segment standard deviations */
+#define OUTLIER_SIGMA 4.0
+
+/*
+ * Scan of the model offset b (in distance units), from where d + b of the nearest sample is MODEL_B_MARGIN,
+ * as b may be negative
+ */
+#define MODEL_B_MARGIN 0.01
+#define MODEL_B_MAX 10.0
+#define MODEL_B_COARSE 0.1
+#define MODEL_B_FINE 0.005
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+static SimTrace* traces;
+static uint32_t traceCount;
+
+/**
+ * @struct Segment_t
+ * @brief Per segment statistics of one pass
+ */
+typedef struct Segment_t
+{
+	uint32_t samples;
+	double residualSum;
+	double nominalErrorSum;
+	double fittedErrorSum;
+} Segment;
+
+/**
+ * @brief Segment of a labeled distance, -1 beyond the table
+ *
+ * @param [in] distance
+ * @param [out] t position within the segment, 0 at its near knot
+ * @return index of the far knot of the segment
+ */
+static int Find_Segment(float distance, double* t)
+{
+	int i;
+
+	if (distance < distanceTable[0] || distance > distanceTable[DIST_LOOKUP_LEN - 1]) return -1;
+
+	for (i = 1; i < DIST_LOOKUP_LEN - 1 && distance > distanceTable[i]; i++);
+	*t = (distance - distanceTable[i - 1]) / (double) (distanceTable[i] - distanceTable[i - 1]);
+	return i;
+}
+
+/**
+ * @brief Least squares knot values, rejecting samples beyond limit[segment] from the previous fit
+ *
+ * @param [in] prior nominal knot values
+ * @param [in] fit previous fit, NULL in the first pass
+ * @param [in] limit residual limit per segment, used with fit
+ * @param [out] knots
+ * @param [out] weights diagonal of the normal equations, for the monotonic projection
+ */
+static void Fit_Knots(const uint16_t* prior, const double* fit, const double* limit, double* knots, double* weights)
+{
+	double diag[DIST_LOOKUP_LEN], upper[DIST_LOOKUP_LEN], rhs[DIST_LOOKUP_LEN];
+	double a, b, t, m;
+	uint32_t tr, k;
+	int i;
+
+	for (i = 0; i < DIST_LOOKUP_LEN; i++)
+	{
+		diag[i] = PRIOR_WEIGHT;
+		upper[i] = 0;
+		rhs[i] = PRIOR_WEIGHT * prior[i];
+	}
+
+	for (tr = 0; tr < traceCount; tr++)
+	{
+		const SimTrace* trace = &traces[tr];
+
+		for (k = 0; k < trace->length; k++)
+		{
+			i = Find_Segment(trace->distance[k], &t);
+			if (i < 0) continue;
+
+			a = 1 - t;
+			b = t;
+			if (fit != NULL && fabs(trace->ps[k] - (a * fit[i - 1] + b * fit[i])) > limit[i]) continue;
+
+			diag[i - 1] += a * a;
+			upper[i - 1] += a * b;
+			diag[i] += b * b;
+			rhs[i - 1] += a * trace->ps[k];
+			rhs[i] += b * trace->ps[k];
+		}
+	}
+
+	memcpy(weights, diag, sizeof(diag));
+
+	//	Symmetric tridiagonal system, Thomas algorithm
+	for (i = 1; i < DIST_LOOKUP_LEN; i++)
+	{
+		m = upper[i - 1] / diag[i - 1];
+		diag[i] -= m * upper[i - 1];
+		rhs[i] -= m * rhs[i - 1];
+	}
+	knots[DIST_LOOKUP_LEN - 1] = rhs[DIST_LOOKUP_LEN - 1] / diag[DIST_LOOKUP_LEN - 1];
+	for (i = DIST_LOOKUP_LEN - 1; i-- > 0;)
+		knots[i] = (rhs[i] - upper[i] * knots[i + 1]) / diag[i];
+}
+
+/**
+ * @brief Weighted projection of the knots onto non-increasing values, pool adjacent violators
+ *
+ * @param [in,out] knots
+ * @param [in] weights
+ */
+static void Make_Monotonic(double* knots, const double* weights)
+{
+	double value[DIST_LOOKUP_LEN], weight[DIST_LOOKUP_LEN];
+	int count[DIST_LOOKUP_LEN];
+	int blocks = 0, i, j, k = 0;
+
+	for (i = 0; i < DIST_LOOKUP_LEN; i++)
+	{
+		value[blocks] = knots[i];
+		weight[blocks] = weights[i];
+		count[blocks] = 1;
+		blocks++;
+
+		//	Merge while a block rises above the one before it
+		while (blocks > 1 && value[blocks - 1] > value[blocks - 2])
+		{
+			double w = weight[blocks - 2] + weight[blocks - 1];
+			value[blocks - 2] = (value[blocks - 2] * weight[blocks - 2] + value[blocks - 1] * weight[blocks - 1]) / w;
+			weight[blocks - 2] = w;
+			count[blocks - 2] += count[blocks - 1];
+			blocks--;
+		}
+	}
+
+	for (i = 0; i < blocks; i++)
+		for (j = 0; j < count[i]; j++) knots[k++] = value[i];
+}
+
+/**
+ * @struct Model_t
+ * @brief Inverse-square model PS = a / (d + b)^2 + c
+ */
+typedef struct Model_t
+{
+	double a;
+	double b;
+	double c;
+
+	/** @brief Weighted mean square residual, ~ square distance error */
+	double error;
+} Model;
+
+/**
+ * @brief Fit a, c for an offset b, keeping the model if it beats the best so far
+ *
+ * PS is linear in x = 1 / (d + b)^2. A PS residual r is a distance residual of r / (2 a x^1.5), so weights
+ * 1 / x^3 fit distance error up to the constant 4 a^2.
+ *
+ * @param [in] distance
+ * @param [in] ps
+ * @param [in] n
+ * @param [in] b
+ * @param [in,out] best
+ */
+static void Fit_Model(const float* distance, const uint16_t* ps, uint32_t n, double b, Model* best)
+{
+	double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, sse = 0, x, w, a, c, det, r;
+	uint32_t k;
+
+	for (k = 0; k < n; k++)
+	{
+		x = 1.0 / ((distance[k] + b) * (distance[k] + b));
+		w = 1.0 / (x * x * x);
+		sw += w;
+		sx += w * x;
+		sy += w * ps[k];
+		sxx += w * x * x;
+		sxy += w * x * ps[k];
+	}
+
+	det = sw * sxx - sx * sx;
+	if (sw == 0 || det <= 0) return;
+
+	a = (sw * sxy - sx * sy) / det;
+	c = (sy - a * sx) / sw;
+	if (a <= 0) return;
+
+	//	Residuals in a second pass, the sums cancel badly
+	for (k = 0; k < n; k++)
+	{
+		x = 1.0 / ((distance[k] + b) * (distance[k] + b));
+		r = ps[k] - a * x - c;
+		sse += r * r / (x * x * x);
+	}
+
+	if (sse / (4 * a * a * n) < best->error)
+	{
+		best->a = a;
+		best->b = b;
+		best->c = c;
+		best->error = sse / (4 * a * a * n);
+	}
+}
+
+/**
+ * @brief Model distance of a PS value, clamped to the table range
+ */
+static double Model_Distance(double ps, const Model* model)
+{
+	double d = (ps > model->c) ? sqrt(model->a / (ps - model->c)) - model->b : distanceTable[DIST_LOOKUP_LEN - 1];
+
+	if (d < distanceTable[0]) return distanceTable[0];
+	return (d > distanceTable[DIST_LOOKUP_LEN - 1]) ? distanceTable[DIST_LOOKUP_LEN - 1] : d;
+}
+
+int main(int argc, char** argv)
+{
+	uint16_t nominal[DIST_LOOKUP_LEN], fitted[DIST_LOOKUP_LEN];
+	double knots[DIST_LOOKUP_LEN], weights[DIST_LOOKUP_LEN], limit[DIST_LOOKUP_LEN];
+	Segment segments[DIST_LOOKUP_LEN];
+	Model model = { 0, 0, 0, 0 };
+	float* modelD;
+	uint16_t* modelPS;
+	uint32_t modelLen = 0;
+	double modelErrorSum = 0, b, t, residual, error, nearest;
+	uint64_t samples = 0, inTable = 0;
+	uint32_t tr, k;
+	struct timespec start, end;
+	int i, opt;
+
+	memcpy(nominal, proximityTable, sizeof(nominal));
+
+	while ((opt = getopt(argc, argv, "p:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'p':
+			{
+				char* next = optarg;
+				for (i = 0; i < DIST_LOOKUP_LEN; i++)
+				{
+					nominal[i] = (uint16_t) strtoul(next, &next, 10);
+					if (*next == ',') next++;
+				}
+				break;
+			}
+			default:
+				fprintf(stderr, "usage: %s [-p nominal_table] trace...\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if (optind >= argc) { fprintf(stderr, "no traces\n"); return 2; }
+
+	traceCount = argc - optind;
+	traces = calloc(traceCount, sizeof(SimTrace));
+	for (tr = 0; tr < traceCount; tr++)
+	{
+		const char* path = argv[optind + tr];
+
+		if (SimTrace_Load(&traces[tr], path) != 0) { fprintf(stderr, "%s: no time_ms,ps,als samples\n", path); return 2; }
+		if (traces[tr].distance == NULL) { fprintf(stderr, "%s: not labeled with distances\n", path); return 2; }
+		samples += traces[tr].length;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	//	First pass on every sample, then residual limits per segment for the second
+	Fit_Knots(nominal, NULL, NULL, knots, weights);
+
+	memset(segments, 0, sizeof(segments));
+	for (tr = 0; tr < traceCount; tr++)
+		for (k = 0; k < traces[tr].length; k++)
+		{
+			i = Find_Segment(traces[tr].distance[k], &t);
+			if (i < 0) continue;
+
+			residual = traces[tr].ps[k] - ((1 - t) * knots[i - 1] + t * knots[i]);
+			segments[i].samples++;
+			segments[i].residualSum += residual * residual;
+		}
+
+	for (i = 1; i < DIST_LOOKUP_LEN; i++)
+	{
+		limit[i] = segments[i].samples ? OUTLIER_SIGMA * sqrt(segments[i].residualSum / segments[i].samples) : INFINITY;
+		inTable += segments[i].samples;
+	}
+
+	Fit_Knots(nominal, knots, limit, knots, weights);
+	Make_Monotonic(knots, weights);
+
+	for (i = 0; i < DIST_LOOKUP_LEN; i++)
+		fitted[i] = (knots[i] < 0) ? 0 : (knots[i] > UINT16_MAX) ? UINT16_MAX : (uint16_t) (knots[i] + 0.5);
+
+	//	Model on the inlier samples short of saturation, a coarse then a fine scan of b
+	modelD = malloc(inTable * sizeof(float));
+	modelPS = malloc(inTable * sizeof(uint16_t));
+	for (tr = 0; tr < traceCount; tr++)
+		for (k = 0; k < traces[tr].length; k++)
+		{
+			i = Find_Segment(traces[tr].distance[k], &t);
+			if (i < 0 || traces[tr].ps[k] == UINT16_MAX) continue;
+
+			residual = traces[tr].ps[k] - ((1 - t) * knots[i - 1] + t * knots[i]);
+			if (fabs(residual) > limit[i]) continue;
+
+			modelD[modelLen] = traces[tr].distance[k];
+			modelPS[modelLen] = traces[tr].ps[k];
+			modelLen++;
+		}
+
+	model.error = INFINITY;
+	nearest = INFINITY;
+	for (k = 0; k < modelLen; k++)
+		if (modelD[k] < nearest) nearest = modelD[k];
+
+	for (b = MODEL_B_MARGIN - nearest; b <= MODEL_B_MAX; b += MODEL_B_COARSE) Fit_Model(modelD, modelPS, modelLen, b, &model);
+	for (b = model.b - MODEL_B_COARSE; b <= model.b + MODEL_B_COARSE; b += MODEL_B_FINE)
+		if (b >= MODEL_B_MARGIN - nearest) Fit_Model(modelD, modelPS, modelLen, b, &model);
+
+	//	Report pass
+	memset(segments, 0, sizeof(segments));
+	for (tr = 0; tr < traceCount; tr++)
+		for (k = 0; k < traces[tr].length; k++)
+		{
+			uint16_t ps = traces[tr].ps[k];
+			float distance = traces[tr].distance[k];
+
+			i = Find_Segment(distance, &t);
+			if (i < 0) continue;
+
+			residual = ps - ((1 - t) * fitted[i - 1] + t * fitted[i]);
+			segments[i].samples++;
+			segments[i].residualSum += residual * residual;
+			error = Distance_Lookup(ps, nominal, (uint16_t *) distanceTable, DIST_LOOKUP_LEN) - distance;
+			segments[i].nominalErrorSum += error * error;
+			error = Distance_Lookup(ps, fitted, (uint16_t *) distanceTable, DIST_LOOKUP_LEN) - distance;
+			segments[i].fittedErrorSum += error * error;
+			error = Model_Distance(ps, &model) - distance;
+			modelErrorSum += error * error;
+		}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	printf("uint16_t proximityTable[DIST_LOOKUP_LEN] = {\n  ");
+	for (i = 0; i < DIST_LOOKUP_LEN; i++) printf("%u%s", fitted[i], (i < DIST_LOOKUP_LEN - 1) ? ", " : "\n};\n");
+	printf("model: PS = a / (d + b)^2 + c, a = %.1f, b = %.3f, c = %.1f, distance error %.3f\n",
+		model.a, model.b, model.c, inTable ? sqrt(modelErrorSum / inTable) : 0);
+	if (model.b < MODEL_B_MARGIN - nearest + MODEL_B_FINE)
+		printf("model: b at its limit, nearest sample at d = %.3f\n", nearest);
+
+	printf("segment,from,to,samples,psResidual,nominalError,fittedError\n");
+	for (i = 1; i < DIST_LOOKUP_LEN; i++)
+	{
+		Segment* s = &segments[i];
+		printf("%d,%u,%u,%u,%.2f,%.3f,%.3f\n", i, distanceTable[i - 1], distanceTable[i], s->samples,
+			s->samples ? sqrt(s->residualSum / s->samples) : 0, s->samples ? sqrt(s->nominalErrorSum / s->samples) : 0,
+			s->samples ? sqrt(s->fittedErrorSum / s->samples) : 0);
+	}
+
+	fprintf(stderr, "%u traces, %llu samples, %llu within the table, %.3f s\n", traceCount,
+		(unsigned long long) samples, (unsigned long long) inTable,
+		(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9);
+
+	return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file firmware_sim.cpp
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Whole firmware run on the virtual clock against the Arduino shims and simulated sensor
+ *
+ * Usage: firmware_sim [-t seconds] [-c task_us] [-r trace | -g seed] [-o serial_file] [-p pixel_file] [-x ms:chars]... [-q] [-i]
+ *
+ * arduino-vishay-controller.ino is built unmodified from sketch.cpp. setup() runs once, then loop() is
+ * called whenever a task is ready; while none is, virtual time jumps to the next release, as the MCU would
+ * spin. Each loop() is charged task_us of CPU time on top of the I2C time charged by the bus, so hours of
+ * firmware run in seconds and the process can be profiled with perf like any host program.
+ *
+ * The simulated VCNL sees a hand approach every few seconds, replays a time_ms,ps,als trace in a loop, e.g.
+ * fr_decode output, or with -g sees the random gestures and ambient events of SimGen. Serial output goes to stdout or serial_file, -q discards it, and -x injects Serial
+ * input, e.g. -x 60000:s sends 's' at 60 s. Changed NeoPixel frames are written to pixel_file. A summary is
+ * printed to stderr, and the run fails if the PS pipeline ever read a conversion still in flight, or with -i
+ * if the rate controller never entered idle sampling, e.g. -g 1 -t 120 -i at SimGen's resting PS.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include "SimArduino.h"
+#include "SimClock.h"
+#include "SimI2C.h"
+#include "SimFirmware.h"
+#include "SimTrace.h"
+#include "SimGen.h"
+#include "Scheduler.h"
+#include "Sensor.h"
+#include "RateControl.h"
+
+#define DEVICE_ADDR 0x51
+#define NO_MUX_ADDR 0x70
+#define CONVERSION_US 800
+#define TASK_COST_US 100
+
+/*
+ * Sketch globals read back for the summary
+ */
+extern Scheduler scheduler;
+extern const char* taskNames[SCHED_MAX_TASKS];
+extern volatile uint32_t toggleCount;
+extern uint16_t proximityTable[DIST_LOOKUP_LEN];
+extern RateControl rateControl;
+
+int main(int argc, char** argv)
+{
+	double seconds = 3600;
+	uint32_t taskCost = TASK_COST_US;
+	FILE* serialFile = NULL;
+	FILE* pixelFile = NULL;
+	SimHand hand = { 1, 5000000, 1500000, 0 };
+	SimTrace trace;
+	SimReplay replay = { NULL, 0, 0 };
+	static SimGen gen;
+	SimGenConfig genConfig;
+	uint32_t genSeed = 0;
+	uint8_t needIdle = 0;
+	SimVcnl* device;
+	struct timespec start, end;
+	uint64_t loops;
+	double wall;
+	int opt;
+	uint8_t i;
+
+	while ((opt = getopt(argc, argv, "t:c:r:g:o:p:x:qi")) != -1)
+	{
+		switch (opt)
+		{
+			case 't':
+				seconds = atof(optarg);
+				break;
+			case 'c':
+				taskCost = atoi(optarg);
+				break;
+			case 'r':
+				if (SimTrace_Load(&trace, optarg) != 0) { fprintf(stderr, "%s: no time_ms,ps,als samples\n", optarg); return 2; }
+				replay.trace = &trace;
+				break;
+			case 'g':
+				genSeed = atoi(optarg);
+				if (genSeed == 0) { fprintf(stderr, "-g expects a seed other than 0\n"); return 2; }
+				break;
+			case 'o':
+				serialFile = fopen(optarg, "w");
+				if (serialFile == NULL) { perror(optarg); return 2; }
+				Sim_Serial_Output(serialFile);
+				break;
+			case 'p':
+				pixelFile = fopen(optarg, "w");
+				if (pixelFile == NULL) { perror(optarg); return 2; }
+				Adafruit_NeoPixel::capture = pixelFile;
+				break;
+			case 'x':
+			{
+				char* text = strchr(optarg, ':');
+				if (text == NULL) { fprintf(stderr, "-x expects ms:chars\n"); return 2; }
+				Sim_Serial_Inject((uint64_t) atof(optarg) * 1000, text + 1);
+				break;
+			}
+			case 'q':
+				Sim_Serial_Output(NULL);
+				break;
+			case 'i':
+				needIdle = 1;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-t seconds] [-c task_us] [-r trace | -g seed] [-o serial_file] [-p pixel_file] [-x ms:chars]... [-q] [-i]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	Init_SimBus(NO_MUX_ADDR, SIM_BYTE_TIME_US);
+	if (replay.trace != NULL)
+		device = SimBus_Add(DEVICE_ADDR, SIM_NO_MUX, CONVERSION_US, SimReplay_PS, SimReplay_ALS, &replay);
+	else if (genSeed != 0)
+	{
+		SimGen_Default(&genConfig);
+		genConfig.seed = genSeed;
+		Init_SimGen(&gen, &genConfig, proximityTable);
+		device = SimBus_Add(DEVICE_ADDR, SIM_NO_MUX, CONVERSION_US, SimGen_PS, SimGen_ALS, &gen);
+	}
+	else
+		device = SimBus_Add(DEVICE_ADDR, SIM_NO_MUX, CONVERSION_US, SimHand_PS, SimHand_ALS, &hand);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	setup();
+
+	loops = SimFirmware_Run(Sim_Now() + (uint64_t) (seconds * 1e6), taskCost);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	wall = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+	Serial.flush();
+	if (serialFile != NULL) fclose(serialFile);
+	if (pixelFile != NULL) fclose(pixelFile);
+
+	fprintf(stderr, "virtual %.1f s, wall %.3f s, %.0fx real time, %llu loops\n",
+		Sim_Now() * 1e-6, wall, Sim_Now() * 1e-6 / wall, (unsigned long long) loops);
+	fprintf(stderr, "i2c: %u transactions, bus busy %.2f%%\n",
+		simBus.transactionCount, 100.0 * simBus.busyTime / Sim_Now());
+	fprintf(stderr, "vcnl: %u writes, %u triggers, %u stale reads\n",
+		device->writeCount, device->triggerCount, device->staleCount);
+	fprintf(stderr, "toggles: %u, LED_BUILTIN changes: %u, pixel shows: %u, frames: %u, serial bytes: %u\n",
+		toggleCount, Sim_Pin_Toggles(LED_BUILTIN), Adafruit_NeoPixel::showCount, Adafruit_NeoPixel::frameCount,
+		Sim_Serial_Written());
+
+	fprintf(stderr, "rate levels entered: active %u, approach %u, idle %u\n", rateControl.enterCount[RATE_ACTIVE],
+		rateControl.enterCount[RATE_APPROACH], rateControl.enterCount[RATE_IDLE]);
+
+	fprintf(stderr, "task,runs,misses,overruns,maxJitter,maxExec\n");
+	for (i = 0; i < SCHED_MAX_TASKS; i++)
+	{
+		SchedTask* task = &scheduler.tasks[i];
+		if (task->callback == NULL) continue;
+
+		fprintf(stderr, "%s,%u,%u,%u,%u,%u\n", taskNames[i], task->runCount, task->missCount, task->overrunCount,
+			task->maxJitter, task->maxExec);
+	}
+
+	//	Pipelined PS reads must never catch a conversion in flight
+	if (device->staleCount > 0)
+	{
+		fprintf(stderr, "FAIL: %u PS reads before conversion end\n", device->staleCount);
+		return 1;
+	}
+
+	//	At a resting PS the sensor must slow down to idle sampling
+	if (needIdle && (rateControl.enterCount[RATE_IDLE] == 0))
+	{
+		fprintf(stderr, "FAIL: idle sampling never entered\n");
+		return 1;
+	}
+
+	return 0;
+}
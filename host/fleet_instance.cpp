@@ -0,0 +1,89 @@
+/**
+ * @file fleet_instance.cpp
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Fleet firmware image entry points, built into libfleet_fw.so with the sketch
+ *
+ * Everything here is instance state and lives in the library's writable data with the sketch globals, so
+ * it is swapped with the rest of the instance image, see FleetInstance.h.
+ */
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include "FleetInstance.h"
+#include "SimArduino.h"
+#include "SimClock.h"
+#include "SimI2C.h"
+#include "SimFirmware.h"
+#include "Scheduler.h"
+
+#define FLEET_EXPORT __attribute__ ((visibility ("default")))
+
+#define DEVICE_ADDR 0x51
+#define NO_MUX_ADDR 0x70
+#define CONVERSION_US 800
+#define HAND_DURATION_US 1500000
+
+/*
+ * Sketch globals read back for the counters
+ */
+extern Scheduler scheduler;
+extern volatile uint32_t toggleCount;
+
+static SimHand hand;
+static SimReplay replay;
+static SimVcnl* device;
+static uint32_t taskCost;
+static uint64_t loops;
+
+extern "C" FLEET_EXPORT void Fleet_Setup(const FleetConfig* config)
+{
+	Sim_Set(0);
+	Sim_Serial_Output(NULL);
+	Init_SimBus(NO_MUX_ADDR, SIM_BYTE_TIME_US);
+
+	if (config->trace != NULL)
+	{
+		replay.trace = config->trace;
+		replay.offset = config->traceOffset;
+		replay.cursor = 0;
+		device = SimBus_Add(DEVICE_ADDR, SIM_NO_MUX, CONVERSION_US, SimReplay_PS, SimReplay_ALS, &replay);
+	}
+	else
+	{
+		hand.seed = config->seed;
+		hand.period = config->handPeriod;
+		hand.duration = HAND_DURATION_US;
+		hand.phase = config->handPhase;
+		device = SimBus_Add(DEVICE_ADDR, SIM_NO_MUX, CONVERSION_US, SimHand_PS, SimHand_ALS, &hand);
+	}
+
+	taskCost = config->taskCost;
+	loops = 0;
+	setup();
+}
+
+extern "C" FLEET_EXPORT void Fleet_Run(uint64_t until)
+{
+	loops += SimFirmware_Run(until, taskCost);
+}
+
+extern "C" FLEET_EXPORT void Fleet_Read(FleetCounters* counters)
+{
+	uint8_t i;
+
+	counters->now = Sim_Now();
+	counters->loops = loops;
+	counters->serialBytes = Sim_Serial_Written();
+	counters->toggles = toggleCount;
+	counters->frames = Adafruit_NeoPixel::frameCount;
+	counters->staleReads = device->staleCount;
+	counters->misses = 0;
+	counters->overruns = 0;
+
+	for (i = 0; i < SCHED_MAX_TASKS; i++)
+	{
+		counters->misses += scheduler.tasks[i].missCount;
+		counters->overruns += scheduler.tasks[i].overrunCount;
+	}
+}
@@ -0,0 +1,375 @@
+/**
+ * @file fleet_sim.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Fleet of whole controller firmwares stepped in virtual time across a thread pool
+ *
+ * Usage: fleet_sim [-n instances] [-j threads] [-t seconds] [-s slice_ms] [-c task_us] [-r trace] [-l library]
+ *
+ * Every worker thread loads its own copy of libfleet_fw.so and owns every j-th instance. An instance's
+ * context is the library's writable data, its globals, so the worker swaps the instance image in, runs the
+ * sketch to the end of the current slice of virtual time, and swaps it out again. Workers meet at a barrier
+ * after every slice, so the whole fleet advances in step, as the telemetry gateway would see it.
+ *
+ * Instances see the synthetic hand approach with per-instance seed, period and phase, or replay one
+ * time_ms,ps,als trace from per-instance offsets. Reports aggregate and per-instance speed against real
+ * time, fleet telemetry rate and the sum of every instance's counters; fails on any stale PS read.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <link.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "FleetInstance.h"
+#include "SimTrace.h"
+
+/** @brief Maximum number of worker threads */
+#define FLEET_MAX_WORKERS 64
+
+/** @brief Maximum number of writable ranges of a library copy */
+#define FLEET_MAX_RANGES 4
+
+#define DEFAULT_LIBRARY "libfleet_fw.so"
+#define TASK_COST_US 100
+
+/**
+ * @struct FleetWorker_t
+ * @brief Worker thread with its copy of the firmware library
+ */
+typedef struct FleetWorker_t
+{
+	/** @brief Worker index, also its first instance */
+	uint32_t index;
+
+	/** @brief Library handle */
+	void* handle;
+
+	/** @brief Entry points of this copy */
+	FleetSetup setup;
+	FleetRun run;
+	FleetRead read;
+
+	/** @brief Writable ranges of this copy, the instance image */
+	uint8_t* rangeStart[FLEET_MAX_RANGES];
+	size_t rangeLength[FLEET_MAX_RANGES];
+	uint8_t rangeCount;
+
+	/** @brief Image right after loading, before any instance set up */
+	uint8_t* pristine;
+
+	pthread_t thread;
+} FleetWorker;
+
+/*
+ * Fleet parameters, shared read-only by the workers
+ */
+static uint32_t instanceCount = 1000;
+static uint32_t workerCount = 1;
+static uint64_t duration = 60000000;
+static uint64_t slice = 1000000;
+static uint32_t taskCost = TASK_COST_US;
+static SimTrace trace;
+static uint8_t useTrace = 0;
+
+static FleetWorker workers[FLEET_MAX_WORKERS];
+static size_t imageSize;
+static uint8_t* images;
+static pthread_barrier_t sliceBarrier;
+
+/**
+ * @brief Find writable ranges of a loaded copy, leaving out the part made read-only after relocation
+ */
+static int Find_Ranges(struct dl_phdr_info* info, size_t size, void* data)
+{
+	FleetWorker* worker = (FleetWorker *) data;
+	struct link_map* map;
+	uintptr_t relroEnd = 0, start, end;
+	uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+	int i;
+
+	if ((dlinfo(worker->handle, RTLD_DI_LINKMAP, &map) != 0) || (info->dlpi_addr != map->l_addr)) return 0;
+
+	for (i = 0; i < info->dlpi_phnum; i++)
+	{
+		if (info->dlpi_phdr[i].p_type == PT_GNU_RELRO)
+			relroEnd = (info->dlpi_addr + info->dlpi_phdr[i].p_vaddr + info->dlpi_phdr[i].p_memsz) & ~(page - 1);
+	}
+
+	for (i = 0; i < info->dlpi_phnum; i++)
+	{
+		if ((info->dlpi_phdr[i].p_type != PT_LOAD) || !(info->dlpi_phdr[i].p_flags & PF_W)) continue;
+		if (worker->rangeCount >= FLEET_MAX_RANGES) return -1;
+
+		start = info->dlpi_addr + info->dlpi_phdr[i].p_vaddr;
+		end = start + info->dlpi_phdr[i].p_memsz;
+		if ((relroEnd > start) && (relroEnd <= end)) start = relroEnd;
+		if (start >= end) continue;
+
+		worker->rangeStart[worker->rangeCount] = (uint8_t *) start;
+		worker->rangeLength[worker->rangeCount] = end - start;
+		worker->rangeCount++;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Load a private copy of the library through an in-memory file
+ *
+ * The loader shares objects by path and file identity, so every copy is loaded from its own memfd, kept open
+ * so that no later copy gets the same /proc/self/fd path.
+ *
+ * @param [out] worker
+ * @param [in] library file contents
+ * @param [in] length
+ * @return 0 on success, -1 otherwise
+ */
+static int Load_Copy(FleetWorker* worker, const uint8_t* library, size_t length)
+{
+	char path[64];
+	int fd = memfd_create("fleet_fw", 0);
+	size_t i;
+
+	if ((fd < 0) || (write(fd, library, length) != (ssize_t) length)) return -1;
+
+	snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+	worker->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if (worker->handle == NULL)
+	{
+		fprintf(stderr, "%s\n", dlerror());
+		return -1;
+	}
+
+	worker->setup = (FleetSetup) dlsym(worker->handle, FLEET_SETUP_SYMBOL);
+	worker->run = (FleetRun) dlsym(worker->handle, FLEET_RUN_SYMBOL);
+	worker->read = (FleetRead) dlsym(worker->handle, FLEET_READ_SYMBOL);
+	if ((worker->setup == NULL) || (worker->run == NULL) || (worker->read == NULL)) return -1;
+
+	if (dl_iterate_phdr(Find_Ranges, worker) != 1) return -1;
+
+	//	Every copy has the same layout
+	for (i = 0, length = 0; i < worker->rangeCount; i++) length += worker->rangeLength[i];
+	if ((imageSize != 0) && (length != imageSize)) return -1;
+	imageSize = length;
+	worker->pristine = malloc(imageSize);
+
+	return 0;
+}
+
+static void Image_Save(const FleetWorker* worker, uint8_t* image)
+{
+	uint8_t i;
+
+	for (i = 0; i < worker->rangeCount; i++)
+	{
+		memcpy(image, worker->rangeStart[i], worker->rangeLength[i]);
+		image += worker->rangeLength[i];
+	}
+}
+
+static void Image_Load(const FleetWorker* worker, const uint8_t* image)
+{
+	uint8_t i;
+
+	for (i = 0; i < worker->rangeCount; i++)
+	{
+		memcpy(worker->rangeStart[i], image, worker->rangeLength[i]);
+		image += worker->rangeLength[i];
+	}
+}
+
+static uint32_t Instance_Random(uint32_t instance, uint32_t salt)
+{
+	//	Integer hash, so every instance's parameters are independent of the worker count
+	uint32_t x = instance * 0x9E3779B1u ^ salt;
+	x ^= x >> 16;
+	x *= 0x85EBCA6Bu;
+	x ^= x >> 13;
+	x *= 0xC2B2AE35u;
+	x ^= x >> 16;
+	return x;
+}
+
+static void* Worker_Main(void* arg)
+{
+	FleetWorker* worker = (FleetWorker *) arg;
+	FleetConfig config;
+	uint64_t until;
+	uint32_t i;
+
+	//	Set up every owned instance from the pristine image
+	for (i = worker->index; i < instanceCount; i += workerCount)
+	{
+		config.seed = Instance_Random(i, 1) | 1;
+		config.handPeriod = 3000000 + Instance_Random(i, 2) % 6000000;
+		config.handPhase = Instance_Random(i, 3) % config.handPeriod;
+		config.trace = useTrace ? &trace : NULL;
+		config.traceOffset = useTrace ? Instance_Random(i, 4) % trace.duration : 0;
+		config.taskCost = taskCost;
+
+		Image_Load(worker, worker->pristine);
+		worker->setup(&config);
+		Image_Save(worker, &images[(size_t) i * imageSize]);
+	}
+	pthread_barrier_wait(&sliceBarrier);
+
+	for (until = slice; until < duration + slice; until += slice)
+	{
+		if (until > duration) until = duration;
+
+		for (i = worker->index; i < instanceCount; i += workerCount)
+		{
+			Image_Load(worker, &images[(size_t) i * imageSize]);
+			worker->run(until);
+			Image_Save(worker, &images[(size_t) i * imageSize]);
+		}
+		pthread_barrier_wait(&sliceBarrier);
+	}
+
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	const char* libraryPath = NULL;
+	char defaultPath[4096];
+	uint8_t* library;
+	struct stat st;
+	FILE* file;
+	FleetCounters counters, total;
+	struct timespec start, end;
+	double wall, seconds;
+	uint32_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:j:t:s:c:r:l:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n':
+				instanceCount = atoi(optarg);
+				break;
+			case 'j':
+				workerCount = atoi(optarg);
+				break;
+			case 't':
+				duration = (uint64_t) (atof(optarg) * 1e6);
+				break;
+			case 's':
+				slice = (uint64_t) (atof(optarg) * 1e3);
+				break;
+			case 'c':
+				taskCost = atoi(optarg);
+				break;
+			case 'r':
+				if (SimTrace_Load(&trace, optarg) != 0) { fprintf(stderr, "%s: no time_ms,ps,als samples\n", optarg); return 2; }
+				useTrace = 1;
+				break;
+			case 'l':
+				libraryPath = optarg;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n instances] [-j threads] [-t seconds] [-s slice_ms] [-c task_us] [-r trace] [-l library]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if ((workerCount < 1) || (workerCount > FLEET_MAX_WORKERS) || (instanceCount < 1) || (slice == 0))
+	{
+		fprintf(stderr, "need 1 to %u threads, at least one instance and a non-zero slice\n", FLEET_MAX_WORKERS);
+		return 2;
+	}
+	if (workerCount > instanceCount) workerCount = instanceCount;
+
+	//	Library next to the executable by default
+	if (libraryPath == NULL)
+	{
+		ssize_t n = readlink("/proc/self/exe", defaultPath, sizeof(defaultPath) - sizeof(DEFAULT_LIBRARY) - 1);
+		char* slash;
+
+		defaultPath[(n > 0) ? n : 0] = '\0';
+		slash = strrchr(defaultPath, '/');
+		strcpy(slash ? slash + 1 : defaultPath, DEFAULT_LIBRARY);
+		libraryPath = defaultPath;
+	}
+
+	file = fopen(libraryPath, "rb");
+	if ((file == NULL) || (fstat(fileno(file), &st) != 0))
+	{
+		perror(libraryPath);
+		return 2;
+	}
+	library = malloc(st.st_size);
+	if (fread(library, 1, st.st_size, file) != (size_t) st.st_size) return 2;
+	fclose(file);
+
+	for (i = 0; i < workerCount; i++)
+	{
+		workers[i].index = i;
+		if (Load_Copy(&workers[i], library, st.st_size) != 0)
+		{
+			fprintf(stderr, "could not load copy %u of %s\n", i, libraryPath);
+			return 2;
+		}
+		Image_Save(&workers[i], workers[i].pristine);
+	}
+
+	images = malloc((size_t) instanceCount * imageSize);
+	if (images == NULL)
+	{
+		fprintf(stderr, "no memory for %u images of %zu bytes\n", instanceCount, imageSize);
+		return 2;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	pthread_barrier_init(&sliceBarrier, NULL, workerCount);
+	for (i = 0; i < workerCount; i++)
+		pthread_create(&workers[i].thread, NULL, Worker_Main, &workers[i]);
+	for (i = 0; i < workerCount; i++)
+		pthread_join(workers[i].thread, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	wall = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+	//	Sum of every instance's counters
+	memset(&total, 0, sizeof(total));
+	for (i = 0; i < instanceCount; i++)
+	{
+		FleetWorker* worker = &workers[i % workerCount];
+
+		Image_Load(worker, &images[(size_t) i * imageSize]);
+		worker->read(&counters);
+		total.now += counters.now;
+		total.loops += counters.loops;
+		total.serialBytes += counters.serialBytes;
+		total.toggles += counters.toggles;
+		total.frames += counters.frames;
+		total.staleReads += counters.staleReads;
+		total.misses += counters.misses;
+		total.overruns += counters.overruns;
+	}
+	seconds = duration * 1e-6;
+
+	printf("fleet: %u instances, %u threads, %zu byte image, %s signal\n", instanceCount, workerCount, imageSize,
+		useTrace ? "trace" : "synthetic");
+	printf("virtual %.1f s per instance, wall %.3f s\n", seconds, wall);
+	printf("speed: %.0fx real time aggregate, %.1fx per instance, %.0fx per thread\n",
+		instanceCount * seconds / wall, seconds / wall, instanceCount * seconds / wall / workerCount);
+	printf("telemetry: %.0f bytes/s from the fleet\n", total.serialBytes / seconds);
+	printf("totals: %llu loops, %u toggles, %u frames, %u misses, %u overruns, %u stale reads\n",
+		(unsigned long long) total.loops, total.toggles, total.frames, total.misses, total.overruns, total.staleReads);
+
+	if (total.staleReads > 0)
+	{
+		fprintf(stderr, "FAIL: %u PS reads before conversion end\n", total.staleReads);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file fr_decode.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Decoder for flight recorder dumps captured from the serial telemetry link
+ *
+ * Usage: fr_decode < capture.txt
+ *
+ * Reads "fr,<block>,<frozen>,<hex>" lines, ignoring any other telemetry, and prints the decoded samples as
+ * time_ms,ps,als in recording order.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "FlightRecorder.h"
+
+/**
+ * @brief Print decoded sample as CSV
+ */
+static void Print_Sample(void* ctx, uint32_t time, uint16_t psVal, uint16_t alsVal)
+{
+	printf("%u,%u,%u\n", time, psVal, alsVal);
+}
+
+int main(void)
+{
+	char line[512];
+	char* hex;
+	unsigned block, frozen, byte;
+	uint8_t data[FR_BLOCK_LEN];
+	int i, valid;
+
+	printf("time_ms,ps,als\n");
+	while (fgets(line, sizeof(line), stdin))
+	{
+		if (sscanf(line, "fr,%u,%u,", &block, &frozen) != 2) continue;
+
+		//	Hex payload follows the third comma
+		hex = strchr(line, ',');
+		hex = hex ? strchr(hex + 1, ',') : NULL;
+		hex = hex ? strchr(hex + 1, ',') : NULL;
+		if (hex == NULL) continue;
+		hex++;
+
+		valid = 1;
+		for (i = 0; i < FR_BLOCK_LEN; i++)
+		{
+			if (sscanf(hex + 2 * i, "%2x", &byte) != 1)
+			{
+				valid = 0;
+				break;
+			}
+			data[i] = (uint8_t) byte;
+		}
+
+		if (!valid)
+		{
+			fprintf(stderr, "skipping truncated block %u\n", block);
+			continue;
+		}
+
+		FlightRecorder_Decode(data, Print_Sample, NULL);
+	}
+
+	return 0;
+}
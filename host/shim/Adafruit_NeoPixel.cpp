@@ -0,0 +1,68 @@
+/**
+ * @file Adafruit_NeoPixel.cpp
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Host shim of the Adafruit NeoPixel library capturing shown frames
+ *
+ * Every show() is counted, and a frame that differs from the previously shown one is counted as a new frame
+ * and, when a capture stream is set, written as one line of time and pixel colours, see SimArduino.h.
+ */
+
+#include <inttypes.h>
+#include "Adafruit_NeoPixel.h"
+#include "SimClock.h"
+
+FILE* Adafruit_NeoPixel::capture = NULL;
+uint32_t Adafruit_NeoPixel::showCount = 0;
+uint32_t Adafruit_NeoPixel::frameCount = 0;
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, neoPixelType type)
+{
+	length = (n < NEOPIXEL_MAX_PIXELS) ? n : NEOPIXEL_MAX_PIXELS;
+	memset(pixels, 0, sizeof(pixels));
+	memset(shown, 0, sizeof(shown));
+}
+
+void Adafruit_NeoPixel::begin(void)
+{
+}
+
+void Adafruit_NeoPixel::show(void)
+{
+	uint16_t i;
+
+	showCount++;
+	if (memcmp(pixels, shown, length * sizeof(uint32_t)) == 0) return;
+
+	memcpy(shown, pixels, length * sizeof(uint32_t));
+	frameCount++;
+
+	//	time_us,RRGGBB per pixel
+	if (capture == NULL) return;
+	fprintf(capture, "%" PRIu64, Sim_Now());
+	for (i = 0; i < length; i++)
+	{
+		fprintf(capture, ",%06" PRIX32, shown[i]);
+	}
+	fputc('\n', capture);
+}
+
+void Adafruit_NeoPixel::clear(void)
+{
+	memset(pixels, 0, length * sizeof(uint32_t));
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c)
+{
+	if (n < length) pixels[n] = c & 0xFFFFFF;
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+{
+	setPixelColor(n, Color(r, g, b));
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
+{
+	return (n < length) ? pixels[n] : 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file Adafruit_NeoPixel.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Host shim of the Adafruit NeoPixel library capturing shown frames
+ *
+ * Every show() is counted, and a frame that differs from the previously shown one is counted as a new frame
+ * and, when a capture stream is set, written as one line of time and pixel colours, see SimArduino.h.
+ */
+
+#ifndef ADAFRUIT_NEOPIXEL_H_
+#define ADAFRUIT_NEOPIXEL_H_
+
+#include <stdio.h>
+#include "Arduino.h"
+
+#define NEO_GRB 0x52
+#define NEO_RGB 0x06
+#define NEO_KHZ800 0x0000
+
+/** @brief Maximum strip length, pixels are held in the object as the strip's RAM on the MCU */
+#define NEOPIXEL_MAX_PIXELS 64
+
+typedef uint16_t neoPixelType;
+
+/**
+ * @class Adafruit_NeoPixel
+ * @brief Pixel strip with frame capture
+ */
+class Adafruit_NeoPixel
+{
+public:
+	Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800);
+
+	void begin(void);
+	void show(void);
+	void clear(void);
+	void setPixelColor(uint16_t n, uint32_t c);
+	void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+	uint32_t getPixelColor(uint16_t n) const;
+	uint16_t numPixels(void) const { return length; }
+
+	static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t) r << 16) | ((uint32_t) g << 8) | b; }
+
+	/** @brief Stream receiving changed frames, NULL to only count them */
+	static FILE* capture;
+
+	/** @brief Number of show() calls over all strips */
+	static uint32_t showCount;
+
+	/** @brief Number of shown frames differing from the previous one over all strips */
+	static uint32_t frameCount;
+
+private:
+	uint16_t length;
+	uint32_t pixels[NEOPIXEL_MAX_PIXELS];
+	uint32_t shown[NEOPIXEL_MAX_PIXELS];
+};
+
+#endif /* ADAFRUIT_NEOPIXEL_H_ */
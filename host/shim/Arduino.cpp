@@ -0,0 +1,234 @@
+/**
+ * @file Arduino.cpp
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Host shim of the Arduino core API used by the sketch
+ *
+ * Only what arduino-vishay-controller.ino uses is provided. Time comes from the virtual clock, with millis()
+ * and micros() wrapping at 32 bits as they do on AVR, digital pins are recorded, and Serial writes to a host
+ * stream and reads bytes injected at virtual times, see SimArduino.h.
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "SimArduino.h"
+#include "SimClock.h"
+
+HardwareSerial Serial;
+
+static FILE* serialOut = stdout;
+static uint32_t serialWritten = 0;
+
+//	Injected input, readable once the virtual time reaches its time
+static struct
+{
+	uint64_t time;
+	char c;
+} serialInput[SIM_SERIAL_INPUT_LEN];
+static uint16_t inputHead = 0;
+static uint16_t inputTail = 0;
+
+static uint8_t pinState[SIM_PIN_COUNT];
+static uint32_t pinToggles[SIM_PIN_COUNT];
+
+unsigned long millis(void)
+{
+	return (uint32_t) (Sim_Now() / 1000);
+}
+
+unsigned long micros(void)
+{
+	return Sim_Micros();
+}
+
+void delay(unsigned long ms)
+{
+	Sim_Advance((uint64_t) ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	Sim_Advance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	if (pin >= SIM_PIN_COUNT) return;
+
+	val = val ? HIGH : LOW;
+	if (pinState[pin] != val) pinToggles[pin]++;
+	pinState[pin] = val;
+}
+
+int digitalRead(uint8_t pin)
+{
+	return (pin < SIM_PIN_COUNT) ? pinState[pin] : LOW;
+}
+
+uint8_t Sim_Pin_State(uint8_t pin)
+{
+	return (pin < SIM_PIN_COUNT) ? pinState[pin] : LOW;
+}
+
+uint32_t Sim_Pin_Toggles(uint8_t pin)
+{
+	return (pin < SIM_PIN_COUNT) ? pinToggles[pin] : 0;
+}
+
+void Sim_Serial_Output(FILE* out)
+{
+	serialOut = out;
+}
+
+uint16_t Sim_Serial_Inject(uint64_t time, const char* text)
+{
+	uint16_t n = 0;
+
+	while ((text[n] != '\0') && ((uint16_t) (inputTail - inputHead) < SIM_SERIAL_INPUT_LEN))
+	{
+		serialInput[inputTail % SIM_SERIAL_INPUT_LEN].time = time;
+		serialInput[inputTail % SIM_SERIAL_INPUT_LEN].c = text[n++];
+		inputTail++;
+	}
+
+	return n;
+}
+
+uint32_t Sim_Serial_Written(void)
+{
+	return serialWritten;
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+}
+
+void HardwareSerial::end(void)
+{
+}
+
+int HardwareSerial::available(void)
+{
+	uint16_t i, n = 0;
+
+	for (i = inputHead; i != inputTail; i++)
+	{
+		if (serialInput[i % SIM_SERIAL_INPUT_LEN].time > Sim_Now()) break;
+		n++;
+	}
+
+	return n;
+}
+
+int HardwareSerial::peek(void)
+{
+	if ((inputHead == inputTail) || (serialInput[inputHead % SIM_SERIAL_INPUT_LEN].time > Sim_Now())) return -1;
+
+	return (uint8_t) serialInput[inputHead % SIM_SERIAL_INPUT_LEN].c;
+}
+
+int HardwareSerial::read(void)
+{
+	int c = peek();
+
+	if (c >= 0) inputHead++;
+	return c;
+}
+
+void HardwareSerial::flush(void)
+{
+	if (serialOut != NULL) fflush(serialOut);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	serialWritten++;
+	if (serialOut != NULL) fputc(c, serialOut);
+	return 1;
+}
+
+size_t HardwareSerial::write(const char* str)
+{
+	size_t n = strlen(str);
+
+	serialWritten += n;
+	if (serialOut != NULL) fwrite(str, 1, n, serialOut);
+	return n;
+}
+
+size_t HardwareSerial::printNumber(unsigned long n, int base)
+{
+	char buf[8 * sizeof(long) + 1];
+	char* str = &buf[sizeof(buf) - 1];
+
+	if (base < 2) base = 10;
+
+	*str = '\0';
+	do
+	{
+		char digit = n % base;
+		*--str = (digit < 10) ? digit + '0' : digit + 'A' - 10;
+		n /= base;
+	} while (n);
+
+	return write(str);
+}
+
+size_t HardwareSerial::print(const char* str)
+{
+	return write(str);
+}
+
+size_t HardwareSerial::print(char c)
+{
+	return write((uint8_t) c);
+}
+
+size_t HardwareSerial::print(unsigned char n, int base)
+{
+	return printNumber(n, base);
+}
+
+size_t HardwareSerial::print(int n, int base)
+{
+	return print((long) n, base);
+}
+
+size_t HardwareSerial::print(unsigned int n, int base)
+{
+	return printNumber(n, base);
+}
+
+size_t HardwareSerial::print(long n, int base)
+{
+	//	As on AVR, only decimal is signed and other bases print the 32 bit two's complement
+	if (base != DEC) return printNumber((uint32_t) n, base);
+	if (n < 0) return write((uint8_t) '-') + printNumber(-(unsigned long) n, DEC);
+	return printNumber(n, DEC);
+}
+
+size_t HardwareSerial::print(unsigned long n, int base)
+{
+	return printNumber(n, base);
+}
+
+size_t HardwareSerial::print(double n, int digits)
+{
+	char buf[48];
+
+	if (isnan(n)) return write("nan");
+	if (isinf(n)) return write("inf");
+	if ((n > 4294967040.0) || (n < -4294967040.0)) return write("ovf");
+
+	snprintf(buf, sizeof(buf), "%.*f", digits, n);
+	return write(buf);
+}
+
+size_t HardwareSerial::println(void)
+{
+	return write("\r\n");
+}
@@ -0,0 +1,100 @@
+/**
+ * @file Arduino.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Host shim of the Arduino core API used by the sketch
+ *
+ * Only what arduino-vishay-controller.ino uses is provided. Time comes from the virtual clock, with millis()
+ * and micros() wrapping at 32 bits as they do on AVR, digital pins are recorded, and Serial writes to a host
+ * stream and reads bytes injected at virtual times, see SimArduino.h.
+ */
+
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define LED_BUILTIN 13
+
+#define BIN 2
+#define OCT 8
+#define DEC 10
+#define HEX 16
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+/*
+ * Sketch entry points
+ */
+void setup(void);
+void loop(void);
+
+/*
+ * Time, on the virtual clock
+ */
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/*
+ * Digital pins
+ */
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+/*
+ * Arduino defines these as macros, templates keep the mixed type calls of the sketch working
+ */
+template <class A, class B> typename std::common_type<A, B>::type min(A a, B b) { return (a < b) ? a : b; }
+template <class A, class B> typename std::common_type<A, B>::type max(A a, B b) { return (a > b) ? a : b; }
+
+/**
+ * @class HardwareSerial
+ * @brief Serial port writing to a host stream and reading injected bytes
+ */
+class HardwareSerial
+{
+public:
+	void begin(unsigned long baud);
+	void end(void);
+	int available(void);
+	int read(void);
+	int peek(void);
+	void flush(void);
+	size_t write(uint8_t c);
+	size_t write(const char* str);
+
+	size_t print(const char* str);
+	size_t print(char c);
+	size_t print(unsigned char n, int base = DEC);
+	size_t print(int n, int base = DEC);
+	size_t print(unsigned int n, int base = DEC);
+	size_t print(long n, int base = DEC);
+	size_t print(unsigned long n, int base = DEC);
+	size_t print(double n, int digits = 2);
+
+	size_t println(void);
+	template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+	template <class T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+
+	operator bool(void) { return true; }
+
+private:
+	size_t printNumber(unsigned long n, int base);
+};
+
+extern HardwareSerial Serial;
+
+#endif /* ARDUINO_H_ */
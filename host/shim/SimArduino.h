@@ -0,0 +1,66 @@
+/**
+ * @file SimArduino.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Header file for the simulation side of the Arduino shims, and related variables, methods
+ *
+ * The sketch only sees the Arduino API; the simulator uses these to feed Serial input, redirect Serial
+ * output and read back pin state.
+ */
+
+#ifndef SIMARDUINO_H_
+#define SIMARDUINO_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+/** @brief Number of simulated digital pins */
+#define SIM_PIN_COUNT 32
+
+/** @brief Maximum number of pending injected Serial bytes */
+#ifndef SIM_SERIAL_INPUT_LEN
+#define SIM_SERIAL_INPUT_LEN 256
+#endif
+
+/**
+ * @brief Redirect Serial output
+ *
+ * @param [in] out stream, NULL discards output
+ */
+void Sim_Serial_Output(FILE* out);
+
+/**
+ * @brief Inject Serial input, readable from a virtual time on
+ *
+ * Injections are expected in time order.
+ *
+ * @param [in] time (in us)
+ * @param [in] text
+ * @return number of bytes injected, less than the text length if the input buffer is full
+ */
+uint16_t Sim_Serial_Inject(uint64_t time, const char* text);
+
+/**
+ * @brief Number of bytes written to Serial
+ *
+ * @return bytes
+ */
+uint32_t Sim_Serial_Written(void);
+
+/**
+ * @brief Latest value written to a pin
+ *
+ * @param [in] pin
+ * @return LOW or HIGH
+ */
+uint8_t Sim_Pin_State(uint8_t pin);
+
+/**
+ * @brief Number of value changes written to a pin
+ *
+ * @param [in] pin
+ * @return toggles
+ */
+uint32_t Sim_Pin_Toggles(uint8_t pin);
+
+#endif /* SIMARDUINO_H_ */
@@ -0,0 +1,92 @@
+/**
+ * @file Wire.cpp
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Host shim of the Arduino Wire library on the simulated I2C bus
+ *
+ * Transmissions are buffered and handed to SimI2C when they end: three bytes with a stop are a register
+ * write, a single byte without a stop sets the register pointer for the following requestFrom(), and a
+ * single byte with a stop to the mux address selects mux channels. Bus time is charged by SimI2C.
+ */
+
+#include "Wire.h"
+#include "SimI2C.h"
+
+/** @brief endTransmission() status for a transaction the simulated bus does not model */
+#define WIRE_OTHER_ERROR 4
+
+TwoWire Wire;
+
+void TwoWire::begin(void)
+{
+	txLength = 0;
+	rxLength = 0;
+	rxIndex = 0;
+}
+
+void TwoWire::end(void)
+{
+}
+
+void TwoWire::setClock(uint32_t clock)
+{
+	//	9 clocks per byte
+	if (clock > 0) simBus.byteTime = (9000000UL + clock - 1) / clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+	this->address = address;
+	txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+	if (txLength >= WIRE_BUFFER_LEN) return 0;
+
+	txBuffer[txLength++] = data;
+	return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+	//	Register pointer, the read itself is charged by requestFrom()
+	if ((txLength == 1) && !sendStop)
+	{
+		pointer = txBuffer[0];
+		return 0;
+	}
+
+	if ((txLength == 1) && (address == simBus.muxAddress))
+		return SimI2C_Select(address, txBuffer[0]);
+
+	if (txLength == 3)
+		return SimI2C_Write(address, txBuffer[0], txBuffer[1], txBuffer[2]);
+
+	return WIRE_OTHER_ERROR;
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity, int sendStop)
+{
+	uint16_t value;
+
+	rxLength = 0;
+	rxIndex = 0;
+
+	if ((quantity != 2) || (SimI2C_Read((uint8_t) address, pointer, &value) != 0)) return 0;
+
+	rxBuffer[0] = value & 0xFF;
+	rxBuffer[1] = value >> 8;
+	rxLength = 2;
+	return rxLength;
+}
+
+int TwoWire::available(void)
+{
+	return rxLength - rxIndex;
+}
+
+int TwoWire::read(void)
+{
+	return (rxIndex < rxLength) ? rxBuffer[rxIndex++] : -1;
+}
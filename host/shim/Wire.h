@@ -0,0 +1,50 @@
+/**
+ * @file Wire.h
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Host shim of the Arduino Wire library on the simulated I2C bus
+ *
+ * Transmissions are buffered and handed to SimI2C when they end: three bytes with a stop are a register
+ * write, a single byte without a stop sets the register pointer for the following requestFrom(), and a
+ * single byte with a stop to the mux address selects mux channels. Bus time is charged by SimI2C.
+ */
+
+#ifndef WIRE_H_
+#define WIRE_H_
+
+#include "Arduino.h"
+
+/** @brief Transmit buffer length */
+#define WIRE_BUFFER_LEN 32
+
+/**
+ * @class TwoWire
+ * @brief I2C master on the simulated bus
+ */
+class TwoWire
+{
+public:
+	void begin(void);
+	void end(void);
+	void setClock(uint32_t clock);
+	void beginTransmission(uint8_t address);
+	void beginTransmission(int address) { beginTransmission((uint8_t) address); }
+	size_t write(uint8_t data);
+	uint8_t endTransmission(bool sendStop = true);
+	uint8_t requestFrom(int address, int quantity, int sendStop = true);
+	int available(void);
+	int read(void);
+
+private:
+	uint8_t address;
+	uint8_t txBuffer[WIRE_BUFFER_LEN];
+	uint8_t txLength;
+	uint8_t pointer;
+	uint8_t rxBuffer[2];
+	uint8_t rxLength;
+	uint8_t rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif /* WIRE_H_ */
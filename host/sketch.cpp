@@ -0,0 +1,9 @@
+/**
+ * @file sketch.cpp
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Host translation unit of the unmodified sketch, as the Arduino builder generates it
+ */
+
+#include <Arduino.h>
+#include "arduino-vishay-controller.ino"
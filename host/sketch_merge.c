@@ -0,0 +1,102 @@
+/**
+ * @file sketch_merge.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Fleet quantiles from PS/ALS sketch dumps captured from the serial telemetry link
+ *
+ * Usage: sketch_merge [capture...]
+ *
+ * Reads "sk,<ps|als>,<halvings>,<total>,<hex>" lines from every capture, or stdin without any, ignoring any
+ * other telemetry. Captures of several units or time ranges are merged per channel, and the merged p5, p50
+ * and p95 printed with the number of sketches and samples.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Sensor.h"
+
+static const double quantiles[3] = { 0.05, 0.5, 0.95 };
+
+/**
+ * @brief Parse a sketch dump line
+ *
+ * @return 0 for PS, 1 for ALS, -1 if the line is not a complete sketch dump
+ */
+static int Parse_Sketch(const char* line, SensorSketch* sketch)
+{
+	char channel[4];
+	unsigned halvings, count;
+	unsigned long total;
+	const char* hex;
+	int i;
+
+	if (sscanf(line, "sk,%3[a-z],%u,%lu,", channel, &halvings, &total) != 3) return -1;
+
+	//	Hex payload follows the fourth comma
+	hex = line;
+	for (i = 0; i < 4 && hex != NULL; i++)
+	{
+		hex = strchr(hex, ',');
+		if (hex != NULL) hex++;
+	}
+	if (hex == NULL) return -1;
+
+	for (i = 0; i < SENSOR_SKETCH_LEN; i++)
+	{
+		if (sscanf(hex + 4 * i, "%4x", &count) != 1) return -1;
+		sketch->count[i] = (uint16_t) count;
+	}
+	sketch->halvings = (uint8_t) halvings;
+	sketch->total = (uint32_t) total;
+
+	if (strcmp(channel, "ps") == 0) return 0;
+	if (strcmp(channel, "als") == 0) return 1;
+	return -1;
+}
+
+static void Merge_File(FILE* file, SensorSketch* merged, uint32_t* sketches)
+{
+	char line[4 * SENSOR_SKETCH_LEN + 64];
+	SensorSketch sketch;
+	int channel;
+
+	while (fgets(line, sizeof(line), file))
+	{
+		channel = Parse_Sketch(line, &sketch);
+		if (channel < 0) continue;
+
+		Sensor_Sketch_Merge(&merged[channel], &sketch);
+		sketches[channel]++;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* names[2] = { "ps", "als" };
+	SensorSketch merged[2];
+	uint32_t sketches[2] = { 0, 0 };
+	FILE* file;
+	int i, j;
+
+	Init_Sensor_Sketch(&merged[0]);
+	Init_Sensor_Sketch(&merged[1]);
+
+	if (argc < 2) Merge_File(stdin, merged, sketches);
+	for (i = 1; i < argc; i++)
+	{
+		file = fopen(argv[i], "r");
+		if (file == NULL) { perror(argv[i]); return 2; }
+		Merge_File(file, merged, sketches);
+		fclose(file);
+	}
+
+	printf("channel,sketches,samples,p5,p50,p95\n");
+	for (i = 0; i < 2; i++)
+	{
+		printf("%s,%u,%u", names[i], sketches[i], merged[i].total);
+		for (j = 0; j < 3; j++) printf(",%.1f", Sensor_Sketch_Quantile(&merged[i], quantiles[j]));
+		printf("\n");
+	}
+
+	return 0;
+}
@@ -0,0 +1,560 @@
+/**
+ * @file sweep.c
+ * @author Kelvin Chan
+ * @date 16 Oct 2026
+ * @brief Parallel sweep of proximity thresholds, window length and filter over labeled traces
+ *
+ * Usage: sweep [-m lo:hi:step] [-M lo:hi:step] [-w lo:hi:step] [-f raw|mean|both] [-d distance] [-g grace_ms]
+ *              [-W false,miss,latency,distance] [-j threads] [-n top] [-o results_file] trace...
+ *
+ * Traces are time_ms,ps,als,distance lines, e.g. from bench_gen, loaded once and shared read-only by all
+ * workers. A hand within -d distance units is an episode the sensor should detect: the first proximity
+ * entry from grace_ms before an episode to grace_ms after it detects it, every other entry is a false
+ * toggle. Every configuration of psProxMin (-m), psProxMax (-M), window length (-w) and filter (-f) is
+ * scored on false toggles, missed episodes, mean detection latency and the RMS error of estimatedDistance
+ * over the labeled distances within the table, and ranked by the weighted sum of those (-W).
+ *
+ * Only the window length changes the Sensor.c outputs other than inProximity, so every trace is replayed
+ * through Update_Sensor_PS() once per window length, recording psMean and the distance error. The
+ * thresholds and the filter then only pick the hysteresis of Update_Proximity() on the raw values or the
+ * recorded means, which is all that is run per configuration. The best configurations are replayed in full
+ * through Sensor.c at the end to check both agree. Both stages are spread over -j threads (default: every
+ * core). The top configurations are printed, and every one is written to results_file with -o.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include "Sensor.h"
+#include "SimTrace.h"
+
+/** @brief Maximum number of worker threads */
+#define SWEEP_MAX_WORKERS 256
+
+/** @brief Configurations taken by a worker at a time */
+#define SWEEP_CHUNK 16
+
+/** @brief Configurations replayed in full through Sensor.c */
+#define SWEEP_VERIFY 4
+
+/*
+ * Hand tuned configuration of the sketch, ranked for reference
+ */
+#define PS_MIN_HYST 680
+#define PS_MAX_HYST 700
+
+#define PRESENCE_DISTANCE 20
+#define GRACE_MS 200
+#define TOP_COUNT 10
+
+static uint16_t proximityTable[DIST_LOOKUP_LEN] = {
+	65535, 18000, 4000, 2000, 1275, 1150, 920, 810, 765, 740, 720, 710, 700, 690, 680, 670
+};
+
+/**
+ * @struct Range_t
+ * @brief Swept parameter values lo, lo + step, ... up to hi
+ */
+typedef struct Range_t
+{
+	uint32_t lo;
+	uint32_t hi;
+	uint32_t step;
+} Range;
+
+/**
+ * @struct Episodes_t
+ * @brief Hand presence episodes of a trace, as sample indices
+ */
+typedef struct Episodes_t
+{
+	/** @brief First sample an entry is attributed to the episode */
+	uint32_t* from;
+
+	/** @brief First sample within the presence distance */
+	uint32_t* start;
+
+	/** @brief Last sample an entry is attributed to the episode */
+	uint32_t* to;
+
+	/** @brief Number of episodes */
+	uint32_t count;
+} Episodes;
+
+/**
+ * @struct SweepConfig_t
+ * @brief One swept configuration and its score over the corpus
+ */
+typedef struct SweepConfig_t
+{
+	uint16_t psProxMin;
+	uint16_t psProxMax;
+	uint8_t window;
+	uint8_t filter;
+
+	/** @brief Proximity entries */
+	uint32_t entries;
+
+	/** @brief Entries outside episodes or after the first in an episode */
+	uint32_t falseToggles;
+
+	/** @brief Episodes without an entry */
+	uint32_t misses;
+
+	/** @brief Detection latency summed over detected episodes (in ms) */
+	uint64_t latencySum;
+
+	/** @brief RMS distance error of the window (in distance units) */
+	double distanceError;
+
+	/** @brief Weighted score, lower is better */
+	double cost;
+} SweepConfig;
+
+/*
+ * Corpus and per window results, shared read-only once built
+ */
+static SimTrace* traces;
+static Episodes* episodes;
+static uint32_t traceCount;
+static uint32_t episodeCount;
+
+/** @brief psMean of every trace sample, per window length index and trace */
+static uint16_t*** means;
+
+/** @brief Squared distance error sum and sample count, per window length index and trace */
+static double** errorSums;
+static uint32_t** errorCounts;
+
+static uint8_t* windows;
+static uint32_t windowCount;
+static SweepConfig* configs;
+static uint32_t configCount;
+static double weights[4] = { 1, 10, 0.01, 1 };
+
+/** @brief Next work item, taken atomically */
+static uint32_t nextItem;
+
+static int Parse_Range(const char* text, Range* range)
+{
+	unsigned lo, hi, step = 1;
+
+	if (sscanf(text, "%u:%u:%u", &lo, &hi, &step) < 2 || step == 0 || hi < lo) return -1;
+	range->lo = lo;
+	range->hi = hi;
+	range->step = step;
+	return 0;
+}
+
+/**
+ * @brief Find presence episodes and their attribution windows, merging episodes closer than the grace time
+ */
+static void Find_Episodes(const SimTrace* trace, Episodes* ep, float presence, uint32_t grace)
+{
+	uint32_t k, f, capacity = 0, end = 0;
+	uint8_t present = 0;
+
+	memset(ep, 0, sizeof(Episodes));
+
+	for (k = 0; k <= trace->length; k++)
+	{
+		uint8_t near = (k < trace->length) && (trace->distance[k] <= presence);
+
+		if (near && !present)
+		{
+			present = 1;
+			if ((ep->count > 0) && (trace->time[k] - trace->time[end] < grace)) continue;
+
+			if (ep->count == capacity)
+			{
+				capacity = capacity ? capacity * 2 : 64;
+				ep->from = realloc(ep->from, capacity * sizeof(uint32_t));
+				ep->start = realloc(ep->start, capacity * sizeof(uint32_t));
+				ep->to = realloc(ep->to, capacity * sizeof(uint32_t));
+			}
+
+			for (f = k; (f > 0) && (trace->time[k] - trace->time[f - 1] <= grace); f--);
+			ep->from[ep->count] = f;
+			ep->start[ep->count] = k;
+			ep->count++;
+		}
+		else if (!near && present)
+		{
+			present = 0;
+			end = k - 1;
+			for (f = end; (f + 1 < trace->length) && (trace->time[f + 1] - trace->time[end] <= grace); f++);
+			ep->to[ep->count - 1] = f;
+		}
+	}
+}
+
+/**
+ * @brief Run the Update_Proximity() hysteresis over a trace and score it against the episodes
+ *
+ * @param [in] t trace index
+ * @param [in] input raw values or window means
+ * @param [in,out] config
+ */
+static void Score_Trace(uint32_t t, const uint16_t* input, SweepConfig* config)
+{
+	const SimTrace* trace = &traces[t];
+	const Episodes* ep = &episodes[t];
+	uint16_t min = config->psProxMin, max = config->psProxMax;
+	uint32_t k, e = 0;
+	uint8_t inProximity = 0, hit = 0;
+
+	for (k = 0; k < trace->length; k++)
+	{
+		if (inProximity)
+		{
+			if (input[k] <= min) inProximity = 0;
+			continue;
+		}
+		if (input[k] < max) continue;
+
+		inProximity = 1;
+		config->entries++;
+
+		while ((e < ep->count) && (k > ep->to[e]))
+		{
+			if (!hit) config->misses++;
+			hit = 0;
+			e++;
+		}
+
+		if ((e < ep->count) && (k >= ep->from[e]) && !hit)
+		{
+			hit = 1;
+			if (trace->time[k] > trace->time[ep->start[e]])
+				config->latencySum += trace->time[k] - trace->time[ep->start[e]];
+		}
+		else
+			config->falseToggles++;
+	}
+
+	for (; e < ep->count; e++)
+	{
+		if (!hit) config->misses++;
+		hit = 0;
+	}
+}
+
+/**
+ * @brief Stage 1 worker: replay traces through Update_Sensor_PS() per window length
+ */
+static void* Replay_Worker(void* arg)
+{
+	const uint32_t last = DIST_LOOKUP_LEN - 1;
+	uint32_t item, k, w, t;
+	Sensor* sensor = malloc(sizeof(Sensor));
+
+	while ((item = __atomic_fetch_add(&nextItem, 1, __ATOMIC_RELAXED)) < windowCount * traceCount)
+	{
+		const SimTrace* trace;
+		double error;
+
+		w = item / traceCount;
+		t = item % traceCount;
+		trace = &traces[t];
+
+		Init_Sensor(sensor, 0, 0, UINT16_MAX, proximityTable);
+		Set_PS_Window(sensor, windows[w]);
+
+		for (k = 0; k < trace->length; k++)
+		{
+			Update_Sensor_PS(sensor, trace->ps[k]);
+			means[w][t][k] = sensor->psMean;
+
+			//	Distances beyond the table can not be estimated
+			if (trace->distance[k] <= distanceTable[last])
+			{
+				error = sensor->estimatedDistance - trace->distance[k];
+				errorSums[w][t] += error * error;
+				errorCounts[w][t]++;
+			}
+		}
+	}
+
+	free(sensor);
+	return NULL;
+}
+
+/**
+ * @brief Stage 2 worker: score configurations in chunks
+ */
+static void* Score_Worker(void* arg)
+{
+	uint32_t item, i, t;
+
+	while ((item = __atomic_fetch_add(&nextItem, SWEEP_CHUNK, __ATOMIC_RELAXED)) < configCount)
+	{
+		for (i = item; (i < item + SWEEP_CHUNK) && (i < configCount); i++)
+		{
+			SweepConfig* config = &configs[i];
+			uint32_t w;
+
+			for (w = 0; windows[w] != config->window; w++);
+			for (t = 0; t < traceCount; t++)
+				Score_Trace(t, (config->filter == SENSOR_FILTER_MEAN) ? means[w][t] : traces[t].ps, config);
+		}
+	}
+
+	return NULL;
+}
+
+static void Run_Workers(void* (*worker)(void*), uint32_t threads)
+{
+	pthread_t workers[SWEEP_MAX_WORKERS];
+	uint32_t i;
+
+	nextItem = 0;
+	for (i = 0; i < threads; i++) pthread_create(&workers[i], NULL, worker, NULL);
+	for (i = 0; i < threads; i++) pthread_join(workers[i], NULL);
+}
+
+static int Compare_Cost(const void* a, const void* b)
+{
+	double ca = ((const SweepConfig *) a)->cost, cb = ((const SweepConfig *) b)->cost;
+	return (ca > cb) - (ca < cb);
+}
+
+/**
+ * @brief Proximity entries of a configuration, replayed in full through Sensor.c
+ */
+static uint32_t Full_Replay(const SweepConfig* config)
+{
+	static Sensor sensor;
+	uint32_t t, k, entries = 0;
+	uint8_t wasInProximity;
+
+	for (t = 0; t < traceCount; t++)
+	{
+		Init_Sensor(&sensor, 0, config->psProxMin, config->psProxMax, proximityTable);
+		Set_PS_Window(&sensor, config->window);
+		sensor.psFilter = config->filter;
+
+		for (k = 0; k < traces[t].length; k++)
+		{
+			wasInProximity = sensor.inProximity;
+			Update_Sensor_PS(&sensor, traces[t].ps[k]);
+			if (!wasInProximity && sensor.inProximity) entries++;
+		}
+	}
+
+	return entries;
+}
+
+static const char* Filter_Name(uint8_t filter)
+{
+	return (filter == SENSOR_FILTER_MEAN) ? "mean" : "raw";
+}
+
+int main(int argc, char** argv)
+{
+	Range minRange = { 650, 700, 5 }, maxRange = { 670, 760, 5 }, windowRange = { 5, 50, 5 };
+	uint8_t filters[2] = { SENSOR_FILTER_RAW, SENSOR_FILTER_MEAN }, filterCount = 2;
+	float presence = PRESENCE_DISTANCE;
+	uint32_t grace = GRACE_MS, top = TOP_COUNT;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t threads = (cores > 0) ? cores : 1;
+	uint64_t samples = 0;
+	const char* resultsPath = NULL;
+	struct timespec start, mid, end;
+	uint32_t i, t, w, f, mismatches = 0;
+	uint32_t psMin, psMax;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "m:M:w:f:d:g:W:j:n:o:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'm':
+				if (Parse_Range(optarg, &minRange) != 0) { fprintf(stderr, "-m expects lo:hi[:step]\n"); return 2; }
+				break;
+			case 'M':
+				if (Parse_Range(optarg, &maxRange) != 0) { fprintf(stderr, "-M expects lo:hi[:step]\n"); return 2; }
+				break;
+			case 'w':
+				if (Parse_Range(optarg, &windowRange) != 0 || windowRange.lo < 1 || windowRange.hi > SENSOR_HIST_LEN)
+				{
+					fprintf(stderr, "-w expects lo:hi[:step] within 1:%d\n", SENSOR_HIST_LEN);
+					return 2;
+				}
+				break;
+			case 'f':
+				filterCount = 1;
+				if (strcmp(optarg, "raw") == 0) filters[0] = SENSOR_FILTER_RAW;
+				else if (strcmp(optarg, "mean") == 0) filters[0] = SENSOR_FILTER_MEAN;
+				else
+				{
+					filters[0] = SENSOR_FILTER_RAW;
+					filterCount = 2;
+				}
+				break;
+			case 'd':
+				presence = atof(optarg);
+				break;
+			case 'g':
+				grace = atoi(optarg);
+				break;
+			case 'W':
+				if (sscanf(optarg, "%lf,%lf,%lf,%lf", &weights[0], &weights[1], &weights[2], &weights[3]) != 4)
+				{
+					fprintf(stderr, "-W expects false,miss,latency,distance\n");
+					return 2;
+				}
+				break;
+			case 'j':
+				threads = atoi(optarg);
+				break;
+			case 'n':
+				top = atoi(optarg);
+				break;
+			case 'o':
+				resultsPath = optarg;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-m lo:hi:step] [-M lo:hi:step] [-w lo:hi:step] [-f raw|mean|both] [-d distance] "
+					"[-g grace_ms] [-W false,miss,latency,distance] [-j threads] [-n top] [-o results_file] trace...\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if (optind >= argc) { fprintf(stderr, "no traces\n"); return 2; }
+	if (threads < 1) threads = 1;
+	if (threads > SWEEP_MAX_WORKERS) threads = SWEEP_MAX_WORKERS;
+
+	//	Corpus, decoded once
+	traceCount = argc - optind;
+	traces = calloc(traceCount, sizeof(SimTrace));
+	episodes = calloc(traceCount, sizeof(Episodes));
+	for (t = 0; t < traceCount; t++)
+	{
+		const char* path = argv[optind + t];
+
+		if (SimTrace_Load(&traces[t], path) != 0) { fprintf(stderr, "%s: no time_ms,ps,als samples\n", path); return 2; }
+		if (traces[t].distance == NULL) { fprintf(stderr, "%s: not labeled with distances\n", path); return 2; }
+
+		Find_Episodes(&traces[t], &episodes[t], presence, grace);
+		episodeCount += episodes[t].count;
+		samples += traces[t].length;
+	}
+
+	//	Grid, window lengths first so configurations sharing means are scored together
+	windowCount = (windowRange.hi - windowRange.lo) / windowRange.step + 1;
+	windows = malloc(windowCount);
+	for (w = 0; w < windowCount; w++) windows[w] = windowRange.lo + w * windowRange.step;
+
+	configs = malloc((size_t) windowCount * filterCount * ((minRange.hi - minRange.lo) / minRange.step + 1) *
+		((maxRange.hi - maxRange.lo) / maxRange.step + 1) * sizeof(SweepConfig));
+	for (w = 0; w < windowCount; w++)
+		for (f = 0; f < filterCount; f++)
+			for (psMin = minRange.lo; psMin <= minRange.hi; psMin += minRange.step)
+				for (psMax = maxRange.lo; psMax <= maxRange.hi; psMax += maxRange.step)
+				{
+					if (psMin >= psMax) continue;
+
+					memset(&configs[configCount], 0, sizeof(SweepConfig));
+					configs[configCount].psProxMin = psMin;
+					configs[configCount].psProxMax = psMax;
+					configs[configCount].window = windows[w];
+					configs[configCount].filter = filters[f];
+					configCount++;
+				}
+
+	if (configCount == 0) { fprintf(stderr, "no configuration with psProxMin < psProxMax\n"); return 2; }
+
+	means = malloc(windowCount * sizeof(uint16_t**));
+	errorSums = malloc(windowCount * sizeof(double*));
+	errorCounts = malloc(windowCount * sizeof(uint32_t*));
+	for (w = 0; w < windowCount; w++)
+	{
+		means[w] = malloc(traceCount * sizeof(uint16_t*));
+		errorSums[w] = calloc(traceCount, sizeof(double));
+		errorCounts[w] = calloc(traceCount, sizeof(uint32_t));
+		for (t = 0; t < traceCount; t++) means[w][t] = malloc(traces[t].length * sizeof(uint16_t));
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	Run_Workers(Replay_Worker, threads);
+	clock_gettime(CLOCK_MONOTONIC, &mid);
+	Run_Workers(Score_Worker, threads);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	for (i = 0; i < configCount; i++)
+	{
+		SweepConfig* config = &configs[i];
+		double errorSum = 0;
+		uint32_t errorCount = 0, detected = episodeCount - config->misses;
+
+		for (w = 0; windows[w] != config->window; w++);
+		for (t = 0; t < traceCount; t++)
+		{
+			errorSum += errorSums[w][t];
+			errorCount += errorCounts[w][t];
+		}
+		config->distanceError = errorCount ? sqrt(errorSum / errorCount) : 0;
+
+		config->cost = weights[0] * config->falseToggles + weights[1] * config->misses +
+			weights[2] * (detected ? (double) config->latencySum / detected : 0) + weights[3] * config->distanceError;
+	}
+	qsort(configs, configCount, sizeof(SweepConfig), Compare_Cost);
+
+	//	Best, and spread over the ranking, replayed in full
+	for (i = 0; i < SWEEP_VERIFY && i < configCount; i++)
+	{
+		const SweepConfig* config = &configs[(uint64_t) i * (configCount - 1) / (SWEEP_VERIFY - 1)];
+		if (Full_Replay(config) != config->entries) mismatches++;
+	}
+
+	printf("corpus: %u traces, %llu samples, %u episodes within %.1f\n",
+		traceCount, (unsigned long long) samples, episodeCount, presence);
+	printf("configurations: %u, threads: %u\n", configCount, threads);
+	printf("replay of %u window lengths: %.3f s, scoring: %.3f s (%.1f ns per sample and configuration)\n",
+		windowCount, (mid.tv_sec - start.tv_sec) + (mid.tv_nsec - start.tv_nsec) * 1e-9,
+		(end.tv_sec - mid.tv_sec) + (end.tv_nsec - mid.tv_nsec) * 1e-9,
+		((end.tv_sec - mid.tv_sec) * 1e9 + (end.tv_nsec - mid.tv_nsec)) / ((double) samples * configCount));
+	printf("full replay check: %u of %u configurations differ\n", mismatches, (configCount < SWEEP_VERIFY) ? configCount : SWEEP_VERIFY);
+
+	for (i = 0; i < configCount; i++)
+	{
+		const SweepConfig* c = &configs[i];
+		if (c->psProxMin == PS_MIN_HYST && c->psProxMax == PS_MAX_HYST && c->window == PS_WINDOW && c->filter == SENSOR_FILTER_RAW)
+			printf("hand tuned %u,%u,%u,raw: rank %u, cost %.3f\n", PS_MIN_HYST, PS_MAX_HYST, PS_WINDOW, i + 1, c->cost);
+	}
+
+	printf("psProxMin,psProxMax,window,filter,entries,falseToggles,misses,meanLatency_ms,distanceError,cost\n");
+	for (i = 0; i < top && i < configCount; i++)
+	{
+		const SweepConfig* c = &configs[i];
+		uint32_t detected = episodeCount - c->misses;
+
+		printf("%u,%u,%u,%s,%u,%u,%u,%.1f,%.3f,%.3f\n", c->psProxMin, c->psProxMax, c->window, Filter_Name(c->filter),
+			c->entries, c->falseToggles, c->misses, detected ? (double) c->latencySum / detected : 0, c->distanceError,
+			c->cost);
+	}
+
+	if (resultsPath != NULL)
+	{
+		FILE* results = fopen(resultsPath, "w");
+		if (results == NULL) { perror(resultsPath); return 2; }
+
+		fprintf(results, "psProxMin,psProxMax,window,filter,entries,falseToggles,misses,meanLatency_ms,distanceError,cost\n");
+		for (i = 0; i < configCount; i++)
+		{
+			const SweepConfig* c = &configs[i];
+			uint32_t detected = episodeCount - c->misses;
+
+			fprintf(results, "%u,%u,%u,%s,%u,%u,%u,%.1f,%.3f,%.3f\n", c->psProxMin, c->psProxMax, c->window,
+				Filter_Name(c->filter), c->entries, c->falseToggles, c->misses,
+				detected ? (double) c->latencySum / detected : 0, c->distanceError, c->cost);
+		}
+		fclose(results);
+	}
+
+	return (mismatches == 0) ? 0 : 1;
+}